@@ -0,0 +1,165 @@
+#!/bin/sh
+
+die () {
+  echo "benchmark/run.sh: error: $*" 1>&2
+  exit 1
+}
+
+usage () {
+cat <<EOUSAGE
+usage: benchmark/run.sh [ <option> ... ] [ <dimacs> ... ]
+
+where '<option>' is one of the following
+
+  -h               print this command line option summary
+  -b <baseline>    compare against '<baseline>' (default 'baseline.csv')
+  -o <report>      write report to '<report>' (default 'report.csv')
+  -s <strategies>  space separated strategies (default from 'strategies.sh')
+  -u               update the baseline with the new report
+
+Runs 'cadiback' with each strategy on each instance (default 'test/*.cnf'
+and 'benchmark/*.cnf') and collects results, statistics and the time to
+find 50%, 90% and 100% of the backbones into a CSV report.  Then time and
+solver calls are compared against the baseline and the script fails if
+the result or the number of backbones changed or if too many calls or too
+much time is needed.
+EOUSAGE
+exit 0
+}
+
+# Allowed relative and absolute increase of solver calls and time.
+
+calls_factor=1.1
+calls_slack=2
+time_factor=1.5
+time_slack=0.1
+
+cd `dirname $0` || exit 1
+
+[ -f ../cadiback ] || die "could not find '../cadiback' (compile it first)"
+
+. ./strategies.sh
+
+baseline=baseline.csv
+report=report.csv
+update=no
+instances=""
+
+while [ $# -gt 0 ]
+do
+  case $1 in
+    -h) usage;;
+    -b) shift; [ $# = 0 ] && die "argument to '-b' missing"; baseline="$1";;
+    -o) shift; [ $# = 0 ] && die "argument to '-o' missing"; report="$1";;
+    -s) shift; [ $# = 0 ] && die "argument to '-s' missing"; strategies="$1";;
+    -u) update=yes;;
+    -*) die "invalid option '$1' (try '-h')";;
+    *) [ -f "$1" ] || die "could not find '$1'"; instances="$instances $1";;
+  esac
+  shift
+done
+
+[ x"$instances" = x ] && instances="`ls ../test/*.cnf *.cnf`"
+
+mkdir -p tmp || exit 1
+log=tmp/benchmark.log
+trace=tmp/benchmark.trace
+
+echo "instance,strategy,status,backbones,dropped,calls,sat,unsat,time,t50,t90,t100" > $report
+
+for instance in $instances
+do
+  name="`basename $instance .cnf`"
+  for strategy in $strategies
+  do
+    if [ $strategy = default ]
+    then
+      options=""
+    else
+      options="`echo $strategy | sed -e 's,^,--,' -e 's,+, --,g'`"
+    fi
+    rm -f $trace
+    ../cadiback -n -s --trace $trace $options $instance 1>$log 2>&1
+    status=$?
+    case $status in
+      10|20) ;;
+      *) die "'../cadiback $options $instance' failed with exit code '$status'";;
+    esac
+    # The backbones found in the trace are attributed to the end of the
+    # call after which they were found, the remaining ones (found by
+    # '--big' before the first call) to the start.
+    line="`awk -F , '
+/^c found .* backbones/ { backbones = $3 }
+/^c dropped .* candidates/ { dropped = $3 }
+/^c called solver/ { calls = $4 }
+/^c satisfiable .* times/ { sat = $3 }
+/^c unsatisfiable .* times/ { unsat = $3 }
+/% total$/ { time = $2 }
+END { printf "%d,%d,%d,%d,%d,%s", backbones, dropped, calls, sat, unsat, time }
+' FS=' ' $log`"
+    backbones="`echo $line | cut -d , -f 1`"
+    times="`awk -F , -v total=$backbones '
+NR > 1 && $13 > 0 { end[++n] = $6 + $7; found[n] = $13; traced += $13 }
+END {
+  for (i = 1; i <= n; i++)
+    for (j = i + 1; j <= n; j++)
+      if (end[j] < end[i]) {
+        tmp = end[i]; end[i] = end[j]; end[j] = tmp
+        tmp = found[i]; found[i] = found[j]; found[j] = tmp
+      }
+  split ("50 90 100", percent, " ")
+  for (k = 1; k <= 3; k++) {
+    if (!total) { printf ",-"; continue }
+    needed = int ((percent[k] * total + 99) / 100)
+    sum = total - traced
+    t = 0
+    for (i = 1; sum < needed && i <= n; i++) { sum += found[i]; t = end[i] }
+    printf ",%.3f", t
+  }
+}
+' $trace`"
+    echo "$name,$strategy,$status,$line$times" >> $report
+    echo "$name $strategy $status `echo $line | tr , ' '``echo $times | tr , ' '`"
+  done
+done
+
+echo "wrote '$report'"
+
+if [ $update = yes ]
+then
+  cp $report $baseline
+  echo "updated '$baseline'"
+  exit 0
+fi
+
+[ -f $baseline ] || die "could not find baseline '$baseline' (use '-u')"
+
+awk -F , \
+  -v calls_factor=$calls_factor -v calls_slack=$calls_slack \
+  -v time_factor=$time_factor -v time_slack=$time_slack '
+FNR == 1 { next }
+NR == FNR { key = $1 "," $2; status[key] = $3; backbones[key] = $4
+            calls[key] = $6; time[key] = $9; next }
+{
+  key = $1 "," $2
+  if (!(key in status)) { print "new " $1 " " $2; next }
+  if ($3 != status[key] || $4 != backbones[key]) {
+    print "MISMATCH " $1 " " $2 ": status " $3 " backbones " $4 \
+          " (baseline status " status[key] " backbones " backbones[key] ")"
+    failed++
+  }
+  if ($6 > calls_factor * calls[key] + calls_slack) {
+    print "REGRESSION " $1 " " $2 ": " $6 " calls (baseline " calls[key] ")"
+    failed++
+  }
+  if ($9 > time_factor * time[key] + time_slack) {
+    print "REGRESSION " $1 " " $2 ": " $9 " seconds (baseline " time[key] ")"
+    failed++
+  }
+  compared++
+}
+END {
+  printf "compared %d runs against baseline with %d failures\n", compared, failed
+  exit (failed > 0)
+}
+' $baseline $report
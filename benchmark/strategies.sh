@@ -0,0 +1,3 @@
+# Extraction strategies compared by 'run.sh'.  Each strategy is a list of
+# long options (without leading '--') joined by '+'.
+strategies="default one-by-one chunking cores big no-flip no-constrain no-filter cores+big chunking+no-flip one-by-one+no-flip"
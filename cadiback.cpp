@@ -1,3 +1,5 @@
+#ifndef NMAIN
+
 // clang-format off
 
 static const char * usage =
@@ -11,29 +13,61 @@ static const char * usage =
 "  -h | --help        print this command line option summary\n"
 "  -l | --logging     extensive logging for debugging\n"
 "  -n | --no-print    do not print backbone\n"
+"  -p | --print-dropped  also print dropped candidates as 'd <idx>' lines\n"
 "  -q | --quiet       disable all messages\n"
 "  -r | --report      report what the SAT solver is doing\n"
 "  -s | --statistics  always print full statistics (not only with '-v')\n"
 "  -v | --verbose     increase verbosity (SAT solver needs three)\n"
 "  -V | --version     print version and exit\n"
 "\n"
+"  --binary           write backbones in compact binary format\n"
+"  --flush <policy>   flush output after 'lines', 'calls' or by 'time'\n"
+"  --flush-interval <s>  with '--flush time' every '<s>' seconds (1)\n"
+"\n"
 "  --no-constrain     use activation literals instead of 'constrain'\n"
 "  --no-filter        do not filter additional candidates\n"
 "  --no-fixed         do not use root-level fixed literal information\n"
 #ifndef NFLIP
 "  --no-flip          do not try to find flippable candidates in models\n"
 "  --really-flip      actually flip flippable candidates in models\n"
+"  --bulk-flip        determine flippable candidates without the solver\n"
 #endif
 "  --no-inprocessing  disable any preprocessing and inprocessing\n"
+"  --no-mmap          parse uncompressed files with the SAT solver too\n"
 "\n"
 "  --chunking         increase constraint size by factor 10 if successful\n"
+"  --adaptive         adapt constraint and core sizes to solver calls\n"
+"  --adaptive-limit <k>  initial constraint size with '--adaptive'\n"
 "  --cores            use core based algorithm as preprocessing step\n"
+"  --core-limit <k>   assume at most '<k>' candidates with '--cores' (100)\n"
+"  --els              decide equivalent candidates together (ELS only)\n"
+"  --probe            probe candidates for failed literals first\n"
+"  --order <o>        candidate order 'index', 'occurrences' or 'binary'\n"
 "  --one-by-one       try candidates one-by-one (do not use 'constrain')\n"
 "  --set-phase        force phases to satisfy negation of candidates\n"
+"  --models <k>       try to find '<k>' more diverse models after a model\n"
+"  --models-limit <k>  limit these calls to '<k>' conflicts (1000)\n"
+"  --cache <k>        refute candidates by the last '<k>' models too\n"
+"  --budget <k>       limit calls to '<k>' conflicts and defer candidates\n"
+"  --threads <n>      split candidates among '<n>' solver copies\n"
+"  --slice <k>/<n>    only determine candidates of the 'k'-th of 'n' slices\n"
+"  --cubes <file>     determine backbones under each cube in '<file>'\n"
+"  --project <file>   only determine the variables listed in '<file>'\n"
+"  --server           answer requests read from '<stdin>' (see below)\n"
+"  --checkpoint <file>  regularly save determined candidates to '<file>'\n"
+"  --checkpoint-interval <s>  save checkpoints every '<s>' seconds (60)\n"
+"  --resume <file>    continue from checkpoint (or output) in '<file>'\n"
+"  --checkers <k>     check claims afterwards with '<k>' checker copies\n"
+"  --verify <file>    only check the backbones in '<file>'\n"
+"  --trace <file>     write all solver calls with timing to '<file>'\n"
+"  --trace-format <f> trace format 'csv' (default), 'json' or 'chrome'\n"
+"  --progress <s>     print progress with ETA every '<s>' seconds\n"
 "\n"
 "  --big              search for backbones in the BIG first\n"
 "  --big-no-els       do not apply ELS to the BIG before extracting backbones\n"
 "  --big-roots        only probe the roots of the ELS\n"
+"  --big-lanes        probe 64 literals at once in the BIG after ELS\n"
+"  --big-reduce       remove transitive edges from the BIG after ELS\n"
 "\n"
 "  --default          set optimization options to the default\n"
 "  --plain            disable all optimizations, which is the same as:\n"
@@ -53,21 +87,55 @@ static const char * usage =
 "formula is read from '<stdin>'.  The same can be achieved by using '-'\n"
 "as first argument. For reading all compressed file types supported by\n"
 "'CaDiCaL' are supported.\n"
+"\n"
+"With '--slice' several processes (for instance on different nodes) can\n"
+"share the work for one formula.  Each process only proves backbones in\n"
+"its own slice of variables but still drops candidates in all slices.\n"
+"Combined with '--print-dropped' the union of all 'b' and 'd' lines\n"
+"of all slices determines the backbone.\n"
+"\n"
+"With '--cubes' the file contains cubes of assumption literals, each\n"
+"terminated by '0' (and 'c' comment lines).  For the cube with index\n"
+"'<id>' (starting with '1') backbones are printed as 'b <id> <lit>' lines\n"
+"followed by 'b <id> 0' and 's <id> SATISFIABLE' or just the line\n"
+"'s <id> UNSATISFIABLE' if the formula is unsatisfiable under the cube.\n"
+"\n"
+"With '--server' the formula is read once and then requests are read\n"
+"from '<stdin>'.  Clauses (terminated by '0') are added for good and a\n"
+"line 'a <lit> ... 0' asks for the backbone under these assumptions with\n"
+"all clauses added so far.  The answer of the '<id>'-th such line has the\n"
+"same format as for '--cubes' and is flushed immediately.\n"
 
 ;
 
 // clang-format on
 
+#endif
+
 #include <cassert>
 #include <cctype>
 #include <climits>
 #include <cstdarg>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 
 #include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
 #include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+// For memory mapping uncompressed DIMACS files.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 // Include the main 'CaDiCaL' API from 'cadical.hpp', but also some helper
 // code from its library (from the 'CaDiCaL' source code directory').
@@ -81,6 +149,10 @@ static const char * usage =
 
 #include "config.hpp"
 
+// The library interface implemented at the end of this file.
+
+#include "cadiback.hpp"
+
 // Verbosity level: -1=quiet, 0=default, 1=verbose, INT_MAX=logging.
 
 static int verbosity;
@@ -91,6 +163,17 @@ static int verbosity;
 static const char *check;
 static CaDiCaL::Solver *checker;
 
+// Checking each literal with its own call to a single checker takes often
+// much longer than the extraction itself.  With '--checkers <k>' the
+// claimed models and backbones are only collected during extraction and
+// afterwards checked in groups by 'k' copies of the checker in parallel
+// (see 'verify_claims').  This is also used by '--verify'.
+//
+static int checkers;
+static std::vector<int> claimed_models, claimed_backbones;
+
+#ifndef NMAIN
+
 // Force writing to CNF alike output file.
 //
 static const char *force;
@@ -99,6 +182,54 @@ static const char *force;
 //
 static const char *no_print;
 
+// The 'b' and 'd' lines are written through our own buffer which by
+// default ('--flush lines') is flushed after every line as before in order
+// to support anytime usage.  With hundreds of thousands of backbones this
+// costs one system call per line.  With '--flush calls' the buffer is only
+// flushed after each solver call and with '--flush time' at most once per
+// 'flush_interval' seconds (one by default or as set by '--flush-interval')
+// and in both cases of course at the end.
+//
+enum { FLUSH_LINES, FLUSH_CALLS, FLUSH_TIME };
+static int flush_policy = FLUSH_LINES;
+static int flush_interval = 1;
+
+// With '--binary' backbones and dropped candidates are written in a
+// compact binary format similar to binary DRAT proofs.  Each record
+// consists of the character 'b' or 'd' followed by the mapped literal
+// '2*idx+sign' ('sign' is '1' for negative literals) as variable-byte
+// encoded number (seven bits per byte, least significant first, with the
+// highest bit set for all but the last byte).  The 'b 0' line becomes the
+// two bytes 'b' and '0' (the latter as byte with value zero).
+//
+static const char *binary;
+
+#endif
+
+// Print dropped candidates as 'd <idx>' lines, which is mostly useful in
+// combination with '--slice' in order to merge the results of several
+// processes.  Every such line is witnessed by a model (in which the
+// candidate literal is false) and thus can be merged safely.
+//
+static const char *print_dropped;
+
+// With '--checkpoint <file>' all backbones and dropped candidates found so
+// far are written as 'b' and 'd' lines to '<file>' every
+// 'checkpoint_interval' seconds (set by '--checkpoint-interval'), at the
+// end and when interrupted (through a temporary file which is then
+// renamed).  Such a file, or the output of an interrupted run with
+// '--print-dropped', is read by '--resume <file>'.  The resumed backbones
+// are assumed while solving for the first model and then become backbones
+// (and the dropped candidates are dropped) without solving.  They are also
+// added as units to the solver.  With '--check' they are still checked.
+//
+static const char *checkpoint;
+#ifndef NMAIN
+static int checkpoint_interval = 60;
+#endif
+static std::vector<int> checkpoint_backbones, checkpoint_dropped;
+static std::vector<int> resumed_backbones, resumed_dropped;
+
 // Disable by default  printing those 'c <character> ...' lines
 // in the solver.  If enabled is useful to see what is going on.
 //
@@ -127,6 +258,14 @@ static const char *no_filter;
 static const char *no_flip;     // No use of flippable information.
 static const char *really_flip; // Also actually flip flippable.
 
+// With '--bulk-flip' we check which candidates are flippable ourselves on
+// a copy of the clauses instead of asking the solver candidate by
+// candidate (see 'sweep_flippable' below).  This is only supported by the
+// stand-alone tool, since the copy has to be taken before the solver can
+// eliminate variables of the formula.
+//
+static const char *bulk_flip;
+
 #endif
 
 // The solver can give back information about root-level fixed literals
@@ -138,6 +277,16 @@ static const char *no_fixed;
 //
 static const char *no_inprocessing;
 
+#ifndef NMAIN
+
+// Uncompressed DIMACS files are memory mapped and parsed by 'CadiBack'
+// itself (in parallel with '--threads') unless this option is given.  Files
+// not in the strict format expected are still parsed by the solver.
+//
+static const char *no_mmap;
+
+#endif
+
 // Force the SAT solver to assign decisions to a value which would make the
 // remaining backbone candidate literals false.  This is a very natural idea
 // but actual had negative effects and thus is now disabled by default.
@@ -156,6 +305,34 @@ static const char *one_by_one;
 //
 static const char *chunking;
 
+// Instead of fixed factors and limits '--adaptive' controls both the size
+// of the constraints and of the cores (with '--cores') multiplicatively.
+// After an unsatisfiable call which was not much slower than an average
+// satisfiable call the limit is doubled.  After a satisfiable call which
+// dropped less than half of the constrained (or assumed) candidates or
+// which took much longer than average the limit is halved.  Average times
+// are smoothed, i.e., exponential moving averages per worker.
+//
+static const char *adaptive;
+
+// With '--cores' at most 'initial_core_limit' candidates are assumed at
+// once ('--core-limit <k>').  With '--adaptive' the first constraint is
+// limited to 'initial_constraint_limit' candidates ('--adaptive-limit <k>'
+// and unlimited if zero).  Both are then adapted by '--adaptive'.
+//
+static int initial_core_limit = 100;
+static int initial_constraint_limit;
+
+// By default the candidates of a slice are tried in the order of their
+// variable index.  With '--order occurrences' the variables occurring in
+// most (irredundant) clauses are tried first and with '--order binary' the
+// variables with the largest degree in the BIG, i.e., occurring in most
+// binary clauses (ties are still broken by index).  Thus the candidates
+// constrained (or assumed) together in one call are the most constrained
+// ones, which are more likely backbones and then proven in one call.
+//
+static const char *order;
+
 // If the following option is enabled we try to compute cores as in
 // 'MiniBones', which assumes the conjunction of the complement of
 // all the remaining backbone candidates.  If solving under this
@@ -183,18 +360,158 @@ static const char *big;
 // This isn't necessary for KB3 but can increase performance.
 static const char *big_no_els;
 
+// Without '--big' this option still applies ELS to the BIG before the
+// first model (but does not search for backbones in the BIG) in order to
+// decide all variables of an equivalence class with one solver call.
+static const char *els;
+
+// Probe the negation of each remaining candidate with unit propagation
+// after the first model and take failed literals as backbones.
+static const char *probe;
+
 // KB3 probes individual literals by propagating them in the BIG. To find
 // all Backbones in the BIG it is sufficent to only probe the roots of the
 // BIG. This can however have detrimental effects for KB3 and is disabled by
 // default. This option requires ELS.
 static const char *big_roots;
 
-static int vars;        // The number of variables in the CNF.
-static int *fixed;      // The resulting fixed backbone literals.
-static int *candidates; // The backbone candidates (if non-zero).
-static int *constraint; // Literals to constrain.
-static int *core;       // Remaining core literals.
-static char *marked;    // Flag used for ELS and BIG propagation.
+// Alternatively probe 64 literals at once with one bit per literal in a
+// reachability mask of each node, which is propagated in topological order
+// through the BIG (which thus requires ELS too).  This allows to probe in
+// parallel with '--threads' but each batch of probes traverses all nodes
+// reachable from its probes again and thus it is disabled by default.
+static const char *big_lanes;
+
+// After ELS the BIG is acyclic and edges implied by paths of length two
+// can be removed without changing reachability, which makes probing
+// cheaper.  This option also sorts the edges of each node by topological
+// order (thus it requires ELS too).
+static const char *big_reduce;
+
+// After each satisfiable call to the solver try to find up to '--models
+// <k>' additional models before the next (more expensive) constrained call.
+// For these calls the phases of all remaining candidates are set to their
+// negation and no assumptions nor constraints are used.  Each model found
+// this way is filtered immediately and we stop as soon as a model does not
+// drop any candidate or the conflict limit of each such call is hit (set
+// by '--models-limit <k>', by default 1000 conflicts).
+//
+static int models;
+static int models_conflict_limit = 1000;
+
+// With '--cache <k>' each worker keeps its last 'k' models (bit-packed
+// values of the candidates at that point) and checks the candidates which
+// go into the next constraint (or are assumed) against them.  With model
+// based filtering (the default) all candidates refuted by a model are
+// dropped immediately and thus this only gives hits if '--no-filter' is
+// specified, where it turns filtering into a lazy check of the candidates
+// actually tried next.
+//
+static int cache;
+
+// Without limit a single hard candidate (or constraint) stalls all the
+// other candidates, which is bad for anytime usage.  With '--budget <k>'
+// each solver call in the main loop is limited to 'k' conflicts. If the
+// limit is hit the candidate is deferred and retried after all other
+// candidates of the slice with a budget doubled in each round.
+//
+static int budget;
+
+// Number of worker threads set with '--threads'.  Each worker gets a copy
+// of the main solver (after the first model is found) and a consecutive
+// slice of the candidate variables.  It only tries to prove backbones in
+// its own slice, but uses its models to drop candidates in all slices.
+// Backbones found by one worker are added as units to all other workers.
+//
+static int threads = 1;
+
+// Similarly '--slice <k>/<n>' splits the variables into 'n' consecutive
+// slices and only the candidates in the 'k'-th slice, i.e., the variables
+// from 'range.begin' to 'range.end', are determined by this process.  The
+// workers of this process further split this range among them.
+//
+static int slice = 1, slices = 1;
+
+// With '--project <file>' only the variables in 'projected' become
+// candidates.  The others are never assumed nor constrained and thus are
+// not determined (except for backbones found in the BIG by '--big').
+//
+static std::vector<bool> projected; // Empty without '--project'.
+static int unprojected;             // Other variables not yet fixed.
+
+#ifndef NMAIN
+
+static const char *project; // File given to '--project'.
+
+// With '--cubes <file>' the backbone is determined under each cube of
+// assumptions in the given file one after the other with the same solver.
+// Backbones of a cube are reused for all its super-sets and the witness
+// models of dropped candidates for all cubes they satisfy.
+//
+static const char *cubes;
+
+// With '--server' requests of clauses and assumptions are read from
+// '<stdin>' and answered one after the other with the same solver.
+//
+static const char *server;
+
+static const char *resume; // File given to '--resume'.
+
+// With '--verify <file>' no backbones are extracted.  Instead the 'b' and
+// 'd' lines in the given file (as written by 'CadiBack' itself) are
+// checked as with '--checkers', where a dropped variable needs models with
+// both values (and the formula has to be satisfiable).
+//
+static const char *verify;
+
+#endif
+
+static struct {
+  int begin, end;
+} range;
+
+static int vars;     // The number of variables in the CNF.
+static char *marked; // Flag used for ELS and BIG propagation.
+
+// The resulting backbones use two bits per variable in 'fixed', i.e., 32
+// variables per word, where the lower bit marks the variable as backbone
+// and the upper bit is its sign.  As the candidate mask below the words are
+// shared by all workers and bits are only set by an atomic 'fetch_or'.
+//
+static std::atomic<uint64_t> *fixed;
+
+// The backbone candidates are kept as two bit-vectors with one bit per
+// variable.  The polarity of a candidate is taken from the first model and
+// never changes, while its bit in the 'candidates' mask is cleared as soon
+// as it is dropped or determined to be a backbone.  This allows to filter
+// all the candidates of a word with a few bit-wise operations and to skip
+// dropped candidates by counting trailing zeroes.
+
+// The mask is shared by all workers without a lock.  A bit is only cleared
+// by an atomic 'fetch_and' and thus exactly one worker succeeds in dropping
+// a candidate or turning it into a backbone.  Only that worker updates
+// 'fixed' and its statistics.
+//
+static std::atomic<uint64_t> *candidates;
+static uint64_t *positive;             // Candidate polarity (non-negated).
+static std::atomic<size_t> determined; // Backbones plus dropped.
+
+// With '--order' the variables of the slice of each worker are permuted
+// and the worker tries the candidate 'permutation[pos]' at position 'pos'
+// of its slice.  Without this permutation positions are variables.
+//
+static int *permutation;
+
+// The equivalence classes of variables found by ELS with '--big' are kept
+// as rings, i.e., 'equivalences[idx]' is the next variable in the class of
+// 'idx' (and '0' if 'idx' is not equivalent to another variable).  Since
+// the candidate polarities are taken from one model, all variables of a
+// class are backbones or none, and as soon as one is determined the others
+// are determined the same way without their own solver call.
+//
+static std::vector<int> equivalences;
+
+#ifndef NMAIN
 
 // Here we have the files on which the tool operators. The first file
 // argument is the '<dimacs>' if specified. Otherwise we will use '<stdin>'.
@@ -209,15 +526,18 @@ struct {
   } dimacs, backbone;
 } files;
 
+#endif
+
 // The actual incrementally used solver for backbone computation is a global
 // variable such that it can be accessed by the signal handler to print
 // statistics even if execution is interrupted or an error occurs.
 //
 static CaDiCaL::Solver *solver;
 
-// Some statistics are collected here.
+// Some statistics are collected here.  Each worker has its own copy which
+// is merged into the global 'statistics' when those are printed.
 
-static struct {
+struct Statistics {
   size_t backbones;     // Number of backbones found.
   size_t dropped;       // Number of non-backbones found.
   size_t filtered;      // Number of candidates with two models.
@@ -226,39 +546,140 @@ static struct {
   size_t failed;        // Failed literals during core based approach.
   size_t core;          // Set by core based approach.
   size_t big_backbones; // Number of backbones found.
+  size_t reused;        // Determined by the previous incremental query.
+  size_t resumed;       // Read from the file given to '--resume'.
+  size_t cached;        // Refuted by a cached model ('--cache').
+  size_t deferred;      // Candidates retried with larger '--budget'.
+  size_t equivalent;    // Determined through equivalent candidates.
+  size_t probed;        // Backbones found by probing ('--probe').
+  struct {
+    size_t increased, decreased; // Constraint limit decisions.
+    size_t core_increased, core_decreased;
+    size_t max_limit, max_core_limit; // Largest limits used.
+  } adaptive;
   struct {
     size_t sat;     // Calls with result SAT to SAT solver.
     size_t unsat;   // Calls with result UNSAT to SAT solver.
     size_t unknown; // Interrupted solver calls.
     size_t total;   // Calls to SAT solver.
+    size_t models;  // Additional calls for diverse models.
   } calls;
 #ifndef NFLIP
   size_t flipped;   // How often 'solver->flip (lit)' succeeded.
   size_t flippable; // How often 'solver->flip (lit)' succeeded.
 #endif
-} statistics;
+};
+
+static Statistics statistics;
+
+// The state of a worker.  Without '--threads' there is only one worker
+// which uses the main solver and has all variables as slice.
+
+struct Worker {
+  int id;                      // Starting with '0' for the main solver.
+  int begin, end;              // Candidate variables slice '[begin,end]'.
+  CaDiCaL::Solver *solver;     // The main solver or a copy of it.
+  std::vector<int> constraint; // Literals to constrain.
+  std::vector<int> core;       // Remaining core literals.
+  size_t imported;             // Number of shared backbones added as units.
+  Statistics statistics;       // Only updated by this worker.
+  bool satisfied;              // Solver has a model (last call was SAT).
+  int witness;                 // Recorded model of last call or '-1'.
+  std::vector<std::vector<uint64_t>> cache; // Last models for '--cache'.
+  size_t cached;                            // Models put into 'cache'.
+  double time;                              // Time of last solver call.
+  double sat_time, unsat_time; // Smoothed call times for '--adaptive'.
+  int budget;                  // Current conflict limit of '--budget'.
+  size_t traced;               // Last trace event (starting with '1').
+  size_t trace_base[5];        // Counts after that event.
+#ifndef NFLIP
+  std::vector<signed char> values;    // Exported model for '--bulk-flip'.
+  std::vector<unsigned> satisfied_by; // True literals per clause.
+  std::vector<unsigned> counted;      // Sweep in which they were counted.
+  unsigned sweeps;                    // Number of exported models.
+#endif
+};
+
+static Worker *workers;
+
+// Backbones in the order they were found in order to import them as units
+// into the other workers (only used with '--threads').
+//
+static std::vector<int> units;
+
+// The library interface in 'cadiback.hpp' allows to determine the backbone
+// under assumptions, which are then assumed in every call to the solver
+// (and the checker).  Assumed variables must not be flipped.
+//
+static std::vector<int> assumptions;
+static std::vector<bool> assumed;
+
+// For incremental queries of the library the models witnessing dropped
+// candidates are recorded bit-packed (at most one per SAT call and only if
+// it dropped a candidate).  A flippable candidate is witnessed by such a
+// model with the candidate variable flipped.  These models remain models
+// after adding clauses which they satisfy.  Thus the next query can drop
+// all candidates with a different value in such a model (if it satisfies
+// the assumptions too) without calling the SAT solver.  Similarly the
+// backbones of the previous query are reused if the assumptions were not
+// reduced.  The library removes models falsifying added clauses before
+// and we only add new models here (while holding the 'shared' lock with
+// '--threads').
+
+struct WitnessModel {
+  int vars;                   // Variables when it was recorded.
+  std::vector<uint64_t> bits; // One value bit per variable.
+};
+
+struct Witnesses {
+  std::vector<WitnessModel> models;
+  std::vector<std::pair<int, int>> flipped; // Model and flipped variable.
+  size_t words;                             // Bits in all 'models'.
+};
+
+static Witnesses *witnesses; // Only set for incremental queries.
+static std::vector<int> reused_backbones;
+
+// Bound on the memory used for recording witnesses (256 MB).  If reached no
+// further witnesses are recorded and their candidates are checked again.
+//
+static const size_t max_witness_words = (size_t) 1 << 25;
+
+// While worker threads are running the 'units', printing backbones and
+// time profiling is protected by the 'shared' lock and the checker by the
+// 'checking' lock.  These are only taken once per SAT call or backbone.
+// The candidate table is not protected by a lock (see below).
+//
+static std::mutex shared, checking;
+static bool parallel;
 
 // Some time profiling information is collected here.
 
 static double first_time, sat_time, unsat_time, solving_time, unknown_time;
 static double satmax_time, unsatmax_time, flip_time, check_time;
+static double models_time;
 static double big_search_time, big_read_time, big_els_time, big_check_time,
-    big_extension_time;
-static volatile double *started, start_time;
+    big_extension_time, big_reduce_time, probe_time;
+static thread_local volatile double *started, start_time;
 
 // Declaring these with '__attribute__ ...' gives nice warnings.
 
+#ifndef NMAIN
 static void die (const char *, ...) __attribute__ ((format (printf, 1, 2)));
+#endif
 static void msg (const char *, ...) __attribute__ ((format (printf, 1, 2)));
 
 static void fatal (const char *, ...)
     __attribute__ ((format (printf, 1, 2)));
 
-// Actual message printing code starts here.
+// Actual message printing code starts here.  Messages are printed in
+// several steps and thus we lock the output file while printing to avoid
+// interleaving them with lines printed by other threads.
 
 static void msg (const char *fmt, ...) {
   if (verbosity < 0)
     return;
+  flockfile (stdout);
   fputs ("c ", stdout);
   va_list ap;
   va_start (ap, fmt);
@@ -266,6 +687,7 @@ static void msg (const char *fmt, ...) {
   va_end (ap);
   fputc ('\n', stdout);
   fflush (stdout);
+  funlockfile (stdout);
 }
 
 static void line () {
@@ -275,6 +697,8 @@ static void line () {
   fflush (stdout);
 }
 
+#ifndef NMAIN
+
 static void die (const char *fmt, ...) {
   fputs ("cadiback: error: ", stderr);
   va_list ap;
@@ -285,9 +709,12 @@ static void die (const char *fmt, ...) {
   exit (1);
 }
 
+#endif
+
 static void dbg (const char *fmt, ...) {
   if (verbosity < INT_MAX)
     return;
+  flockfile (stdout);
   fputs ("c CADIBACK ", stdout);
   va_list ap;
   va_start (ap, fmt);
@@ -295,6 +722,7 @@ static void dbg (const char *fmt, ...) {
   va_end (ap);
   fputc ('\n', stdout);
   fflush (stdout);
+  funlockfile (stdout);
 }
 
 static void fatal (const char *fmt, ...) {
@@ -311,7 +739,272 @@ static void fatal (const char *fmt, ...) {
 static double average (double a, double b) { return b ? a / b : 0; }
 static double percent (double a, double b) { return average (100 * a, b); }
 
-static double time () { return CaDiCaL::absolute_process_time (); }
+// With several threads process time would also account for the time spent
+// in other threads and thus we use wall-clock time instead (relative to the
+// start of 'main').
+
+static double start_real_time;
+
+static double time () {
+  if (threads > 1)
+    return CaDiCaL::absolute_real_time () - start_real_time;
+  return CaDiCaL::absolute_process_time ();
+}
+
+static void lock_shared () {
+  if (parallel)
+    shared.lock ();
+}
+
+// With '--trace <file>' every SAT solver call is recorded as an event with
+// its kind ('first', 'single', 'constrained', 'core', 'models' or 'check'),
+// the number of assumed (or constrained) literals, the result, the start
+// (wall-clock time), its wall-clock and process time, and the number of
+// candidates dropped, filtered, flipped (or flippable) and fixed as well as
+// the backbones found by the worker after this call until its next call.
+// The events are written at the end in the format selected by
+// '--trace-format', which is 'csv' (the default), 'json' (an array of
+// objects) or 'chrome' (for the trace viewer of 'Chrome' with one row per
+// worker).  Process time includes all threads with '--threads'.
+
+static const char *trace;
+#ifndef NMAIN
+static const char *trace_format = "csv";
+#endif
+
+struct TraceEvent {
+  int worker; // Negative for checkers.
+  const char *kind;
+  int size, res;
+  double start, wall, process;
+  size_t dropped, filtered, flipped, fixed, backbones;
+};
+
+static std::vector<TraceEvent> trace_events;
+static std::mutex tracing; // Checkers do not use the 'shared' lock.
+
+static double real_time () {
+  return CaDiCaL::absolute_real_time () - start_real_time;
+}
+
+struct TraceClock {
+  double wall, process;
+};
+
+static TraceClock trace_clock () {
+  TraceClock res = {0, 0};
+  if (trace) {
+    res.wall = real_time ();
+    res.process = CaDiCaL::absolute_process_time ();
+  }
+  return res;
+}
+
+static size_t trace_event (int worker, const char *kind, int size, int res,
+                           const TraceClock &clock) {
+  TraceEvent event;
+  event.worker = worker;
+  event.kind = kind;
+  event.size = size;
+  event.res = res;
+  event.start = clock.wall;
+  event.wall = real_time () - clock.wall;
+  event.process = CaDiCaL::absolute_process_time () - clock.process;
+  event.dropped = event.filtered = event.flipped = event.fixed = 0;
+  event.backbones = 0;
+  std::lock_guard<std::mutex> guard (tracing);
+  trace_events.push_back (event);
+  return trace_events.size ();
+}
+
+// For anytime usage it matters how fast backbones are found.  Thus the
+// time is recorded when the number of backbones (or dropped candidates)
+// reaches a power of two as well as when the last backbone is found.  With
+// '--progress <seconds>' the solver call wrapper further prints a progress
+// line every '<seconds>' seconds with an estimate of the time needed for
+// the remaining candidates from the solver calls per determined candidate
+// and the time per call since the previous progress line.
+
+static int progress;
+
+static std::atomic<size_t> backbones_reached, dropped_reached;
+static double backbone_milestones[64], dropped_milestones[64];
+static size_t last_backbone; // Largest backbone count timed.
+static double last_backbone_time;
+
+static double progress_time;       // Time of last progress line.
+static size_t progress_determined; // Determined candidates at that time.
+static size_t progress_calls;      // Solver calls at that time.
+static size_t solver_calls;        // Solver calls of all workers.
+
+static void reset_milestones () {
+  backbones_reached = dropped_reached = 0;
+  for (unsigned i = 0; i != 64; i++)
+    backbone_milestones[i] = dropped_milestones[i] = -1;
+  last_backbone = 0;
+  last_backbone_time = 0;
+  progress_time = time ();
+  progress_determined = progress_calls = solver_calls = 0;
+}
+
+// Only the first time a power of two is reached is recorded, which keeps
+// the original times if the BIG backbones are determined again by '-c'.
+
+static size_t reach_milestone (std::atomic<size_t> &count, double *times) {
+  const size_t res = ++count;
+  if (!(res & (res - 1))) {
+    double &milestone = times[__builtin_ctzll (res)];
+    if (milestone < 0)
+      milestone = time ();
+  }
+  return res;
+}
+
+// Needs to hold the 'shared' lock (or run before workers are started).
+
+static void reach_backbone_milestone () {
+  const size_t reached =
+      reach_milestone (backbones_reached, backbone_milestones);
+  if (reached > last_backbone) {
+    last_backbone = reached;
+    last_backbone_time = time ();
+  }
+}
+
+static void unlock_shared () {
+  if (parallel)
+    shared.unlock ();
+}
+
+// Programs embedding the 'Backbone' class of 'cadiback.hpp' receive
+// backbones and dropped candidates through these callbacks instead of 'b'
+// and 'd' lines.  Both are called while holding the 'shared' lock.
+
+static std::function<void (int)> backbone_callback, dropped_callback;
+
+#ifndef NMAIN
+
+static char output_buffer[1 << 16];
+static size_t output_size;
+static double output_flushed;
+
+static void flush_output () {
+  FILE *file = files.backbone.file;
+  if (!file)
+    return;
+  if (output_size) {
+    if (fwrite (output_buffer, 1, output_size, file) != output_size)
+      fatal ("failed to write backbones to '%s'", files.backbone.path);
+    output_size = 0;
+  }
+  fflush (file);
+  output_flushed = time ();
+}
+
+static void write_char (char ch) {
+  if (output_size == sizeof output_buffer)
+    flush_output ();
+  output_buffer[output_size++] = ch;
+}
+
+static void write_string (const char *str) {
+  while (*str)
+    write_char (*str++);
+}
+
+// Formatting integers with 'fprintf' is surprisingly expensive, compared
+// to generating the digits in reverse order ourselves.
+
+static void write_number (uint64_t number) {
+  char digits[20];
+  int size = 0;
+  do
+    digits[size++] = '0' + number % 10;
+  while (number /= 10);
+  while (size)
+    write_char (digits[--size]);
+}
+
+static void write_int (int i) {
+  if (i < 0)
+    write_char ('-');
+  write_number (i < 0 ? -(int64_t) i : i);
+}
+
+static void write_varint (uint64_t number) {
+  while (number > 127) {
+    write_char ((char) (128 | (number & 127)));
+    number >>= 7;
+  }
+  write_char ((char) number);
+}
+
+// Write a 'b' or 'd' record with the cube 'id' (if non-zero).  Cubes are
+// not supported by the binary format.
+
+static void write_record (char type, size_t id, int lit) {
+  write_char (type);
+  if (binary) {
+    assert (!id);
+    write_varint (2 * (uint64_t) abs (lit) + (lit < 0));
+  } else {
+    if (id) {
+      write_char (' ');
+      write_number (id);
+    }
+    write_char (' ');
+    write_int (lit);
+    write_char ('\n');
+  }
+  if (flush_policy == FLUSH_LINES)
+    flush_output ();
+  else if (flush_policy == FLUSH_TIME &&
+           time () - output_flushed >= flush_interval)
+    flush_output ();
+}
+
+static double checkpointed;
+
+static void write_checkpoint () {
+  std::string tmp = std::string (checkpoint) + ".tmp";
+  FILE *file = fopen (tmp.c_str (), "w");
+  if (!file)
+    fatal ("can not write checkpoint to '%s'", tmp.c_str ());
+  fprintf (file, "c checkpoint after %.2f seconds\n", time ());
+  for (auto lit : checkpoint_backbones)
+    fprintf (file, "b %d\n", lit);
+  for (auto idx : checkpoint_dropped)
+    fprintf (file, "d %d\n", idx);
+  if (fclose (file) || rename (tmp.c_str (), checkpoint))
+    fatal ("failed to write checkpoint '%s'", checkpoint);
+  checkpointed = time ();
+  dbg ("wrote checkpoint with %zu backbones and %zu dropped candidates",
+       checkpoint_backbones.size (), checkpoint_dropped.size ());
+}
+
+#endif
+
+static void output_backbone (int lit) {
+  if (checkpoint)
+    checkpoint_backbones.push_back (lit);
+  if (backbone_callback)
+    backbone_callback (lit);
+#ifndef NMAIN
+  else if (!no_print)
+    write_record ('b', 0, lit);
+#endif
+}
+
+static void output_dropped (int idx) {
+  if (checkpoint)
+    checkpoint_dropped.push_back (idx);
+  if (dropped_callback)
+    dropped_callback (idx);
+#ifndef NMAIN
+  else if (print_dropped)
+    write_record ('d', 0, idx);
+#endif
+}
 
 static void start_timer (double *timer) {
   assert (!started);
@@ -325,10 +1018,77 @@ static double stop_timer () {
   started = 0;
   double end = time ();
   double delta = end - start_time;
+  lock_shared ();
   *timer += delta;
+  unlock_shared ();
   return delta;
 }
 
+static void add_statistics (Statistics &dst, const Statistics &src) {
+  dst.backbones += src.backbones;
+  dst.dropped += src.dropped;
+  dst.filtered += src.filtered;
+  dst.checked += src.checked;
+  dst.fixed += src.fixed;
+  dst.failed += src.failed;
+  dst.core += src.core;
+  dst.big_backbones += src.big_backbones;
+  dst.reused += src.reused;
+  dst.resumed += src.resumed;
+  dst.cached += src.cached;
+  dst.deferred += src.deferred;
+  dst.equivalent += src.equivalent;
+  dst.probed += src.probed;
+  dst.adaptive.increased += src.adaptive.increased;
+  dst.adaptive.decreased += src.adaptive.decreased;
+  dst.adaptive.core_increased += src.adaptive.core_increased;
+  dst.adaptive.core_decreased += src.adaptive.core_decreased;
+  dst.adaptive.max_limit =
+      std::max (dst.adaptive.max_limit, src.adaptive.max_limit);
+  dst.adaptive.max_core_limit =
+      std::max (dst.adaptive.max_core_limit, src.adaptive.max_core_limit);
+  dst.calls.sat += src.calls.sat;
+  dst.calls.unsat += src.calls.unsat;
+  dst.calls.unknown += src.calls.unknown;
+  dst.calls.total += src.calls.total;
+  dst.calls.models += src.calls.models;
+#ifndef NFLIP
+  dst.flipped += src.flipped;
+  dst.flippable += src.flippable;
+#endif
+}
+
+static void merge_statistics () {
+  if (!workers)
+    return; // Already merged by the library after 'extract'.
+  statistics = Statistics ();
+  for (int i = 0; i != threads; i++)
+    add_statistics (statistics, workers[i].statistics);
+}
+
+// The times recorded for the backbone and dropped candidate counts.
+
+static void print_milestones () {
+  if (!always_print_statistics && verbosity <= 0 && !progress)
+    return;
+  const size_t found = backbones_reached, dropped = dropped_reached;
+  if (!found && !dropped)
+    return;
+  printf ("c\n");
+  printf ("c --- [ backbone progress ] ");
+  printf ("-------------------------------------------------\n");
+  printf ("c\n");
+  for (size_t count = 1, i = 0; count <= found; count *= 2, i++)
+    printf ("c %13zu backbones  reached after %9.2f seconds\n", count,
+            backbone_milestones[i]);
+  if (found & (found - 1))
+    printf ("c %13zu backbones  reached after %9.2f seconds\n",
+            last_backbone, last_backbone_time);
+  for (size_t count = 1, i = 0; count <= dropped; count *= 2, i++)
+    printf ("c %13zu dropped    reached after %9.2f seconds\n", count,
+            dropped_milestones[i]);
+}
+
 static void print_statistics () {
   if (verbosity < 0)
     return;
@@ -338,10 +1098,12 @@ static void print_statistics () {
   if (started) {
     double delta = stop_timer ();
     if (timer == &solving_time) {
-      statistics.calls.unknown++;
+      if (workers)
+        workers->statistics.calls.unknown++;
       unknown_time += delta;
     }
   }
+  merge_statistics ();
   printf ("c\n");
   printf ("c --- [ backbone statistics ] ");
   printf ("------------------------------------------------\n");
@@ -368,6 +1130,24 @@ static void print_statistics () {
           percent (statistics.big_backbones, statistics.backbones));
   printf ("c failed        %9zu candidates    %3.0f%%\n", statistics.failed,
           percent (statistics.failed, vars));
+  if (statistics.reused)
+    printf ("c reused        %9zu candidates    %3.0f%%\n",
+            statistics.reused, percent (statistics.reused, vars));
+  if (statistics.resumed)
+    printf ("c resumed       %9zu candidates    %3.0f%%\n",
+            statistics.resumed, percent (statistics.resumed, vars));
+  if (cache)
+    printf ("c cached        %9zu candidates    %3.0f%%\n",
+            statistics.cached, percent (statistics.cached, vars));
+  if (budget)
+    printf ("c deferred      %9zu candidates    %3.0f%%\n",
+            statistics.deferred, percent (statistics.deferred, vars));
+  if (probe)
+    printf ("c probed        %9zu candidates    %3.0f%%\n",
+            statistics.probed, percent (statistics.probed, vars));
+  if (statistics.equivalent)
+    printf ("c equivalent    %9zu candidates    %3.0f%%\n",
+            statistics.equivalent, percent (statistics.equivalent, vars));
   printf ("c\n");
   printf ("c called solver %9zu times         %3.0f%%\n",
           statistics.calls.total,
@@ -378,6 +1158,30 @@ static void print_statistics () {
   printf ("c unsatisfiable %9zu times         %3.0f%%\n",
           statistics.calls.unsat,
           percent (statistics.calls.unsat, statistics.calls.total));
+  if (models)
+    printf ("c models        %9zu times         %3.0f%%\n",
+            statistics.calls.models,
+            percent (statistics.calls.models, statistics.calls.total));
+  if (adaptive) {
+    const auto &controller = statistics.adaptive;
+    const size_t total = statistics.calls.total;
+    printf ("c\n");
+    printf ("c increased     %9zu times         %3.0f%%\n",
+            controller.increased, percent (controller.increased, total));
+    printf ("c decreased     %9zu times         %3.0f%%\n",
+            controller.decreased, percent (controller.decreased, total));
+    printf ("c max limit     %9zu literals\n", controller.max_limit);
+    if (cores) {
+      printf ("c core up       %9zu times         %3.0f%%\n",
+              controller.core_increased,
+              percent (controller.core_increased, total));
+      printf ("c core down     %9zu times         %3.0f%%\n",
+              controller.core_decreased,
+              percent (controller.core_decreased, total));
+      printf ("c max core      %9zu literals\n", controller.max_core_limit);
+    }
+  }
+  print_milestones ();
   printf ("c\n");
   printf ("c --- [ backbone profiling ] ");
   printf ("-------------------------------------------------\n");
@@ -406,13 +1210,22 @@ static void print_statistics () {
   if (verbosity > 0 || flip_time)
     printf ("c   %10.2f %6.2f %% flip\n", flip_time,
             percent (flip_time, total_time));
-
-  if (big && (verbosity > 0 || big_read_time))
+  if (probe && (verbosity > 0 || probe_time))
+    printf ("c   %10.2f %6.2f %% probe\n", probe_time,
+            percent (probe_time, total_time));
+  if (models && (verbosity > 0 || models_time))
+    printf ("c   %10.2f %6.2f %% models\n", models_time,
+            percent (models_time, total_time));
+
+  if ((big || els) && (verbosity > 0 || big_read_time))
     printf ("c   %10.2f %6.2f %% big_read\n", big_read_time,
             percent (big_read_time, total_time));
-  if (big && (verbosity > 0 || big_els_time))
+  if ((big || els) && (verbosity > 0 || big_els_time))
     printf ("c   %10.2f %6.2f %% big_no_els\n", big_els_time,
             percent (big_els_time, total_time));
+  if (big_reduce && (verbosity > 0 || big_reduce_time))
+    printf ("c   %10.2f %6.2f %% big_reduce\n", big_reduce_time,
+            percent (big_reduce_time, total_time));
   if (big && (verbosity > 0 || big_search_time))
     printf ("c   %10.2f %6.2f %% big_search\n", big_search_time,
             percent (big_search_time, total_time));
@@ -429,6 +1242,8 @@ static void print_statistics () {
   printf ("c ====================================\n");
   printf ("c   %10.2f 100.00 %% total\n", total_time);
   printf ("c\n");
+  printf ("c   %10.2f MB maximum resident set size\n",
+          CaDiCaL::maximum_resident_set_size () / (double) (1 << 20));
   printf ("c\n");
   fflush (stdout);
   if (!solver)
@@ -438,30 +1253,229 @@ static void print_statistics () {
   solver->resources ();
 }
 
+#ifndef NMAIN
+
 class CadiBackSignalHandler : public CaDiCaL::Handler {
   virtual void catch_signal (int sig) {
     if (verbosity < 0)
       return;
+    flush_output ();
+    if (checkpoint)
+      write_checkpoint ();
     printf ("c caught signal %d\n", sig);
     print_statistics ();
   }
 };
 
+#endif
+
 static int remaining_candidates () {
-  size_t determined = statistics.dropped + statistics.backbones;
-  assert (determined <= (size_t) vars);
-  return vars - determined;
+  size_t res = determined + unprojected;
+  assert (res <= (size_t) vars);
+  return vars - res;
+}
+
+// Print a '--progress' line (while holding the 'shared' lock).
+
+static void report_progress () {
+  const double now = time ();
+  const size_t current = determined;
+  const int remain = remaining_candidates ();
+  const size_t delta = current - progress_determined;
+  const size_t calls = solver_calls - progress_calls;
+  const double seconds = now - progress_time;
+  if (delta && calls) {
+    const double calls_per_candidate = calls / (double) delta;
+    const double time_per_call = seconds / calls;
+    msg ("progress %zu backbones %zu dropped %d remain %.0f%% "
+         "ETA %.2f seconds (%.2f calls per candidate %.3f seconds "
+         "per call) after %.2f seconds",
+         (size_t) backbones_reached, (size_t) dropped_reached, remain,
+         percent (remain, vars),
+         remain * calls_per_candidate * time_per_call,
+         calls_per_candidate, time_per_call, now);
+  } else
+    msg ("progress %zu backbones %zu dropped %d remain %.0f%% "
+         "ETA unknown after %.2f seconds",
+         (size_t) backbones_reached, (size_t) dropped_reached, remain,
+         percent (remain, vars), now);
+  progress_time = now;
+  progress_determined = current;
+  progress_calls = solver_calls;
+}
+
+static uint64_t candidate_bit (int idx) {
+  return (uint64_t) 1 << (idx & 63);
+}
+
+static uint64_t candidate_word (int word) {
+  return candidates[word].load (std::memory_order_relaxed);
+}
+
+static int candidate (int idx) {
+  const int word = idx >> 6;
+  const uint64_t bit = candidate_bit (idx);
+  if (!(candidate_word (word) & bit))
+    return 0;
+  return (positive[word] & bit) ? idx : -idx;
 }
 
-// Provide a wrapper function for calling the main solver.
+static int permuted (int pos) {
+  return permutation ? permutation[pos] : pos;
+}
+
+static int fixed_literal (int idx) {
+  const unsigned shift = 2 * (idx & 31);
+  const uint64_t word = fixed[idx >> 5].load (std::memory_order_relaxed);
+  const unsigned bits = (word >> shift) & 3;
+  if (!(bits & 1))
+    return 0;
+  return (bits & 2) ? -idx : idx;
+}
+
+static void fix_literal (int lit) {
+  const int idx = abs (lit);
+  const uint64_t bits = lit < 0 ? 3 : 1;
+  fixed[idx >> 5].fetch_or (bits << (2 * (idx & 31)),
+                            std::memory_order_relaxed);
+}
+
+static void clear_fixed () {
+  const int words = (vars >> 5) + 1;
+  for (int word = 0; word != words; word++)
+    fixed[word] = 0;
+}
+
+static void init_fixed () {
+  fixed = new std::atomic<uint64_t>[(vars >> 5) + 1];
+  if (!fixed)
+    fatal ("out-of-memory allocating backbone result array");
+  clear_fixed ();
+}
+
+static void release_fixed () {
+  delete[] fixed;
+  fixed = 0;
+}
+
+static void init_candidates () {
+  const int words = (vars >> 6) + 1;
+  candidates = new std::atomic<uint64_t>[words];
+  positive = new uint64_t[words];
+  if (!candidates || !positive)
+    fatal ("out-of-memory allocating backbone candidate array");
+  for (int word = 0; word != words; word++)
+    candidates[word] = positive[word] = 0;
+}
+
+static void add_candidate (int lit) {
+  const int idx = abs (lit);
+  const int word = idx >> 6;
+  const uint64_t bit = candidate_bit (idx);
+  candidates[word] |= bit;
+  if (lit > 0)
+    positive[word] |= bit;
+}
+
+static void release_candidates () {
+  delete[] candidates;
+  delete[] positive;
+  candidates = 0;
+  positive = 0;
+}
+
+// Returns 'false' if another worker removed the candidate in the mean time.
+
+static bool remove_candidate (int idx, int lit) {
+  assert (lit == candidate (idx) || !candidate (idx));
+  (void) lit;
+  const uint64_t bit = candidate_bit (idx);
+  const uint64_t previous =
+      candidates[idx >> 6].fetch_and (~bit, std::memory_order_relaxed);
+  if (!(previous & bit))
+    return false;
+  determined++;
+  return true;
+}
+
+// Find the first remaining candidate from 'idx' to 'end' by skipping over
+// clear bits of the mask a word at a time.  Returns 'end + 1' if there is
+// no such candidate.
+
+static int next_candidate (int idx, int end) {
+  while (idx <= end) {
+    const uint64_t above = ~(uint64_t) 0 << (idx & 63);
+    const uint64_t word = candidate_word (idx >> 6) & above;
+    if (word) {
+      idx = (idx & ~63) + __builtin_ctzll (word);
+      return idx <= end ? idx : end + 1;
+    }
+    idx = (idx & ~63) + 64;
+  }
+  return end + 1;
+}
+
+static void assume_assumptions (CaDiCaL::Solver *solver) {
+  for (auto lit : assumptions)
+    solver->assume (lit);
+}
+
+static void cache_model (Worker *);
+
+// The counts of a worker traced after each call.
+
+static void trace_counts (Worker *worker, size_t counts[5]) {
+  const Statistics &statistics = worker->statistics;
+  counts[0] = statistics.dropped;
+  counts[1] = statistics.filtered;
+#ifndef NFLIP
+  counts[2] = statistics.flipped + statistics.flippable;
+#else
+  counts[2] = 0;
+#endif
+  counts[3] = statistics.fixed;
+  counts[4] = statistics.backbones;
+}
+
+// Set the counts of the last traced event of the worker.
+
+static void finish_trace_event (Worker *worker) {
+  if (!worker->traced)
+    return;
+  size_t counts[5];
+  trace_counts (worker, counts);
+  std::lock_guard<std::mutex> guard (tracing);
+  TraceEvent &event = trace_events[worker->traced - 1];
+  event.dropped = counts[0] - worker->trace_base[0];
+  event.filtered = counts[1] - worker->trace_base[1];
+  event.flipped = counts[2] - worker->trace_base[2];
+  event.fixed = counts[3] - worker->trace_base[3];
+  event.backbones = counts[4] - worker->trace_base[4];
+  worker->traced = 0;
+}
 
-static int solve () {
+static void trace_worker_call (Worker *worker, const char *kind, int size,
+                               int res, const TraceClock &clock) {
+  worker->traced = trace_event (worker->id, kind, size, res, clock);
+  trace_counts (worker, worker->trace_base);
+}
+
+// Provide a wrapper function for calling the solver of a worker.  The
+// 'kind' of the call and the number of assumed or constrained literals
+// 'size' are only used for '--trace'.
+
+static int solve (Worker *worker, const char *kind, int size) {
+  CaDiCaL::Solver *solver = worker->solver;
   assert (solver);
+  if (trace)
+    finish_trace_event (worker);
+  const TraceClock clock = trace_clock ();
   start_timer (&solving_time);
-  statistics.calls.total++;
+  worker->statistics.calls.total++;
   {
     char prefix[32];
-    snprintf (prefix, sizeof prefix, "c #%zu ", statistics.calls.total);
+    snprintf (prefix, sizeof prefix, "c #%zu ",
+              worker->statistics.calls.total);
     solver->prefix (prefix);
   }
   int remain = remaining_candidates ();
@@ -470,30 +1484,55 @@ static int solve () {
     msg ("---- [ "
          "SAT solver call #%zu (%d candidates remain %.0f%%)"
          " ] ----",
-         statistics.calls.total, remain, percent (remain, vars));
+         worker->statistics.calls.total, remain, percent (remain, vars));
     line ();
   } else if (verbosity > 0)
     msg ("SAT solver call %zu (%d candidates remain %0.f%%)",
-         statistics.calls.total, remain, percent (remain, vars));
+         worker->statistics.calls.total, remain, percent (remain, vars));
+  assume_assumptions (solver);
   int res = solver->solve ();
+  worker->satisfied = (res == 10);
+  worker->witness = -1;
   if (res == 10) {
-    statistics.calls.sat++;
-  } else {
-    assert (res == 20);
-    statistics.calls.unsat++;
+    worker->statistics.calls.sat++;
+    if (cache)
+      cache_model (worker);
+  } else if (res == 20)
+    worker->statistics.calls.unsat++;
+  else {
+    assert (!res);
+    worker->statistics.calls.unknown++;
   }
   double delta = stop_timer ();
-  if (statistics.calls.total == 1)
+  worker->time = delta;
+  if (trace)
+    trace_worker_call (worker, kind, size, res, clock);
+  lock_shared ();
+  if (!worker->id && worker->statistics.calls.total == 1)
     first_time = delta;
+  solver_calls++;
+  if (progress && time () - progress_time >= progress)
+    report_progress ();
   if (res == 10) {
     sat_time += delta;
     if (delta > satmax_time)
       satmax_time = delta;
-  } else {
+  } else if (!res)
+    unknown_time += delta;
+  else {
     unsat_time += delta;
     if (delta > unsatmax_time)
       unsatmax_time = delta;
   }
+#ifndef NMAIN
+  if (flush_policy == FLUSH_CALLS ||
+      (flush_policy == FLUSH_TIME &&
+       time () - output_flushed >= flush_interval))
+    flush_output ();
+  if (checkpoint && time () - checkpointed >= checkpoint_interval)
+    write_checkpoint ();
+#endif
+  unlock_shared ();
   return res;
 }
 
@@ -503,60 +1542,166 @@ static int solve () {
 // each literal.  The checker solver is copied from the main incremental
 // solver after parsing. The first model of the main solver is not checked.
 
-static void inc_checked () {
+// With '--threads' the checker is protected by the 'checking' lock.
+
+static void inc_checked (Worker *worker) {
   assert (checker);
-  statistics.checked++;
+  size_t checked = ++worker->statistics.checked;
   char prefix[32];
-  snprintf (prefix, sizeof prefix, "c C%zu ", statistics.checked);
+  snprintf (prefix, sizeof prefix, "c C%zu ", checked);
   checker->prefix (prefix);
 }
 
-static void check_model (int lit) {
+static void claim (Worker *worker, std::vector<int> &claims, int lit) {
+  if (parallel)
+    checking.lock ();
+  inc_checked (worker);
+  claims.push_back (lit);
+  if (parallel)
+    checking.unlock ();
+}
+
+static void check_model (Worker *worker, int lit) {
+  if (checkers) {
+    claim (worker, claimed_models, lit);
+    return;
+  }
   double *timer = (double *) started;
   if (timer)
     stop_timer ();
   start_timer (&check_time);
-  inc_checked ();
+  if (parallel)
+    checking.lock ();
+  inc_checked (worker);
   dbg ("checking that there is a model with %d", lit);
+  const TraceClock clock = trace_clock ();
+  assume_assumptions (checker);
   checker->assume (lit);
   int tmp = checker->solve ();
+  if (trace)
+    trace_event (-1, "check", 1, tmp, clock);
   if (tmp != 10)
     fatal ("checking claimed model for %d failed", lit);
+  if (parallel)
+    checking.unlock ();
   stop_timer ();
   if (timer)
     start_timer (timer);
 }
 
-static void check_backbone (int lit) {
+static void check_backbone (Worker *worker, int lit) {
+  if (checkers) {
+    claim (worker, claimed_backbones, lit);
+    return;
+  }
   start_timer (&check_time);
-  inc_checked ();
+  if (parallel)
+    checking.lock ();
+  inc_checked (worker);
   dbg ("checking that there is no model with %d", -lit);
+  const TraceClock clock = trace_clock ();
+  assume_assumptions (checker);
   checker->assume (-lit);
   int tmp = checker->solve ();
+  if (trace)
+    trace_event (-1, "check", 1, tmp, clock);
   if (tmp != 20)
     fatal ("checking %d backbone failed", -lit);
+  if (parallel)
+    checking.unlock ();
   stop_timer ();
 }
 
-// The given variable was proven not be a backbone variable.
+// Record the current model of the worker as witness (once per SAT call)
+// and with 'flipped' the candidate variable to be flipped in it.
 
-static void drop_candidate (int idx) {
-  int lit = candidates[idx];
-  dbg ("dropping candidate literal %d", lit);
-  assert (lit);
-  candidates[idx] = 0;
-  assert (!fixed[idx]);
-  assert (statistics.dropped < (size_t) vars);
-  statistics.dropped++;
-  if (set_phase)
-    solver->unphase (idx);
-  if (check)
-    check_model (-lit);
+static void record_witness (Worker *worker, int idx, bool flipped) {
+  if (!worker->satisfied)
+    return;
+  if (worker->witness < 0) {
+    const int words = (vars >> 6) + 1;
+    WitnessModel model;
+    model.vars = vars;
+    model.bits.resize (words);
+    for (int other = 1; other <= vars; other++)
+      if (worker->solver->val (other) > 0) // Legacy support.
+        model.bits[other >> 6] |= candidate_bit (other);
+    lock_shared ();
+    if (witnesses->words + words <= max_witness_words) {
+      worker->witness = witnesses->models.size ();
+      witnesses->models.push_back (std::move (model));
+      witnesses->words += words;
+    }
+    unlock_shared ();
+    if (worker->witness < 0) {
+      worker->satisfied = false; // Do not try again for this model.
+      return;
+    }
+  }
+  if (flipped) {
+    lock_shared ();
+    witnesses->flipped.push_back ({worker->witness, idx});
+    unlock_shared ();
+  }
 }
 
-#ifndef NFLIP
+// The given variable was proven not be a backbone variable.  Returns
+// 'false' if it was dropped by another worker already.  With 'flipped' it
+// was dropped since it is flippable in the current model.
 
-// This is a technique first implemented in 'Kitten' for SAT sweeping within
+static bool drop_single_candidate (Worker *worker, int idx, bool flipped) {
+  int lit = candidate (idx);
+  if (!lit || !remove_candidate (idx, lit))
+    return false;
+  dbg ("dropping candidate literal %d", lit);
+  assert (!fixed_literal (idx));
+  assert (worker->statistics.dropped < (size_t) vars);
+  worker->statistics.dropped++;
+  reach_milestone (dropped_reached, dropped_milestones);
+  if (witnesses)
+    record_witness (worker, idx, flipped);
+  if (print_dropped || dropped_callback || checkpoint) {
+    lock_shared ();
+    output_dropped (idx);
+    unlock_shared ();
+  }
+  if (set_phase)
+    worker->solver->unphase (idx);
+  if (check)
+    check_model (worker, -lit);
+  return true;
+}
+
+// Flipping a variable with equivalent variables in the model would
+// falsify a binary clause of the equivalence.  Thus if this happens anyhow
+// (the solver might have substituted the equivalences) the model is no
+// witness for the other variables, which are then left to be checked.
+
+static bool drop_candidate (Worker *worker, int idx, bool flipped = false) {
+  if (!drop_single_candidate (worker, idx, flipped))
+    return false;
+  if (!equivalences.empty () && !flipped)
+    for (int other = equivalences[idx]; other && other != idx;
+         other = equivalences[other])
+      if (drop_single_candidate (worker, other, false))
+        worker->statistics.equivalent++;
+  return true;
+}
+
+// Literals are mapped to nodes 'ind (lit)' (as for the BIG, '--bulk-flip'
+// and '--probe'), back with 'lit (u)' and 'var (u)' and negated by 'neg'.
+
+static int ind (int i) {
+  assert (i);
+  return (abs (i) << 1) - 1 - (i > 0);
+}
+static int lit (int i) { return ((i >> 1) + 1) * ((i & 1) ? -1 : 1); }
+static int var (int i) { return (i >> 1) + 1; }
+static int neg (int i) { return i ^ 1; }
+
+#ifndef NFLIP
+
+// This is a technique first implemented in 'Kitten' for SAT sweeping within
 // 'Kissat', which checks whether it is possible to flip the value of a
 // literal in a model of the formula without making the formula false.  It
 // goes over the watches of the literal and checks if all watched clauses
@@ -577,37 +1722,193 @@ static void drop_candidate (int idx) {
 // support flipping we keep it under compile time control too (beside
 // allowing to disable it during run-time).
 
-static void try_to_flip_remaining (int start) {
+// For '--bulk-flip' the irredundant clauses are copied once before the
+// first solver call as zero terminated literals, together with the
+// root-level units (which 'CaDiCaL' does not traverse as clauses).  The
+// occurrence lists of literals are kept in compressed sparse row format
+// as for the BIG, i.e., the clauses of literal 'lit' are those from
+// 'sweep_occurs[ind (lit)]' to 'sweep_occurs[ind (lit) + 1]'.
+
+// After each model the worker exports the values of all variables once
+// and counts the true literals in clauses lazily.  A candidate is
+// flippable if all clauses in which it occurs contain another true
+// literal.  With '--really-flip' the counters are updated after each flip
+// and then candidates which can be flipped together are found.  Thus this
+// sweep replaces the walk over the watches of each candidate by the
+// solver, which 'CaDiCaL' starts from scratch for every model.
+
+static std::vector<int> sweep_literals;
+static std::vector<size_t> sweep_clauses; // Start of clauses in literals.
+static std::vector<size_t> sweep_occurs;
+static std::vector<unsigned> sweep_occurrences;
+
+#ifndef NMAIN
+
+// Duplicated literals would be counted twice and tautological clauses are
+// always satisfied, so we normalize clauses while copying them.
+
+class SweepClauseCopier : public CaDiCaL::ClauseIterator {
+public:
+  std::vector<int> sorted;
+  bool clause (const std::vector<int> &c) {
+    sorted = c;
+    std::sort (sorted.begin (), sorted.end (), [] (int a, int b) {
+      return abs (a) < abs (b) || (abs (a) == abs (b) && a < b);
+    });
+    sorted.erase (std::unique (sorted.begin (), sorted.end ()),
+                  sorted.end ());
+    for (size_t i = 1; i < sorted.size (); i++)
+      if (sorted[i - 1] == -sorted[i])
+        return true;
+    sweep_clauses.push_back (sweep_literals.size ());
+    for (auto lit : sorted)
+      sweep_literals.push_back (lit);
+    sweep_literals.push_back (0);
+    return true;
+  }
+};
+
+static void init_sweep () {
+  SweepClauseCopier copier;
+  solver->traverse_clauses (copier);
+  for (int idx = 1; idx <= vars; idx++) {
+    const int value = solver->fixed (idx);
+    if (!value)
+      continue;
+    sweep_clauses.push_back (sweep_literals.size ());
+    sweep_literals.push_back (value < 0 ? -idx : idx);
+    sweep_literals.push_back (0);
+  }
+  const size_t num_nodes = 2 * (size_t) vars;
+  sweep_occurs.assign (num_nodes + 1, 0);
+  for (auto lit : sweep_literals)
+    if (lit)
+      sweep_occurs[ind (lit) + 1]++;
+  for (size_t u = 0; u != num_nodes; u++)
+    sweep_occurs[u + 1] += sweep_occurs[u];
+  sweep_occurrences.resize (sweep_occurs[num_nodes]);
+  std::vector<size_t> next (sweep_occurs.begin (), sweep_occurs.end () - 1);
+  for (size_t c = 0; c != sweep_clauses.size (); c++)
+    for (size_t i = sweep_clauses[c]; sweep_literals[i]; i++)
+      sweep_occurrences[next[ind (sweep_literals[i])]++] = c;
+  msg ("copied %zu clauses for bulk flipping", sweep_clauses.size ());
+}
+
+#endif
+
+static void sweep_model (Worker *worker) {
+  CaDiCaL::Solver *solver = worker->solver;
+  worker->values.resize (vars + 1);
+  for (int idx = 1; idx <= vars; idx++)
+    worker->values[idx] = solver->val (idx) < 0 ? -1 : 1; // Legacy support.
+  if (worker->counted.empty ()) {
+    worker->satisfied_by.resize (sweep_clauses.size ());
+    worker->counted.resize (sweep_clauses.size ());
+  }
+  worker->sweeps++;
+}
+
+static int sweep_value (Worker *worker, int lit) {
+  const int value = worker->values[abs (lit)];
+  return lit < 0 ? -value : value;
+}
+
+static unsigned satisfied_by (Worker *worker, unsigned c) {
+  if (worker->counted[c] == worker->sweeps)
+    return worker->satisfied_by[c];
+  unsigned count = 0;
+  for (size_t i = sweep_clauses[c]; sweep_literals[i]; i++)
+    if (sweep_value (worker, sweep_literals[i]) > 0)
+      count++;
+  worker->counted[c] = worker->sweeps;
+  worker->satisfied_by[c] = count;
+  return count;
+}
+
+static bool sweep_flippable (Worker *worker, int lit) {
+  if (sweep_value (worker, lit) < 0)
+    return false;
+  const int u = ind (lit);
+  for (size_t i = sweep_occurs[u]; i != sweep_occurs[u + 1]; i++)
+    if (satisfied_by (worker, sweep_occurrences[i]) < 2)
+      return false;
+  return true;
+}
+
+static void sweep_count (Worker *worker, int lit, int delta) {
+  const int u = ind (lit);
+  for (size_t i = sweep_occurs[u]; i != sweep_occurs[u + 1]; i++) {
+    const unsigned c = sweep_occurrences[i];
+    if (worker->counted[c] == worker->sweeps)
+      worker->satisfied_by[c] += delta;
+  }
+}
+
+static void sweep_flip (Worker *worker, int lit) {
+  assert (sweep_value (worker, lit) > 0);
+  worker->values[abs (lit)] *= -1;
+  sweep_count (worker, lit, -1);
+  sweep_count (worker, -lit, 1);
+}
+
+static void try_to_flip_candidate (Worker *worker, int idx) {
+  int lit = candidate (idx);
+  if (!lit)
+    return;
+  if (!assumed.empty () && assumed[idx])
+    return;
+  CaDiCaL::Solver *solver = worker->solver;
+  if (really_flip) {
+    if (bulk_flip && !sweep_flippable (worker, lit))
+      return;
+    if (!solver->flip (lit))
+      return;
+    if (bulk_flip)
+      sweep_flip (worker, lit);
+    worker->witness = -1; // Model changed.
+    if (!drop_candidate (worker, idx))
+      return;
+    dbg ("flipped literal %d", lit);
+    worker->statistics.flipped++;
+  } else {
+    if (bulk_flip ? !sweep_flippable (worker, lit)
+                  : !solver->flippable (lit))
+      return;
+    if (!drop_candidate (worker, idx, true))
+      return;
+    dbg ("literal %d can be flipped", lit);
+    worker->statistics.flippable++;
+  }
+}
+
+// With '--threads' the candidates before the slice of the worker are
+// still undetermined and thus we wrap around and also try those.
+
+static void try_to_flip_remaining (Worker *worker, int start) {
 
   if (no_flip)
     return;
 
   start_timer (&flip_time);
 
-  for (int idx = start; idx <= vars; idx++) {
-    int lit = candidates[idx];
-    if (!lit)
-      continue;
-    if (really_flip) {
-      if (!solver->flip (lit))
-        continue;
-      dbg ("flipped literal %d", lit);
-      statistics.flipped++;
-    } else {
-      if (!solver->flippable (lit))
-        continue;
-      dbg ("literal %d can be flipped", lit);
-      statistics.flippable++;
-    }
-    drop_candidate (idx);
-  }
+  if (bulk_flip)
+    sweep_model (worker);
+
+  for (int idx = next_candidate (start, vars); idx <= vars;
+       idx = next_candidate (idx + 1, vars))
+    try_to_flip_candidate (worker, idx);
+
+  const int end = worker->begin - 1;
+  for (int idx = next_candidate (1, end); idx <= end;
+       idx = next_candidate (idx + 1, end))
+    try_to_flip_candidate (worker, idx);
 
   stop_timer ();
 }
 
 #else
 
-#define try_to_flip_remaining(START) \
+#define try_to_flip_remaining(WORKER, START) \
   do { \
   } while (0)
 
@@ -616,39 +1917,104 @@ static void try_to_flip_remaining (int start) {
 // If the SAT solver has a model in which the candidate backbone literal for
 // the given variable index is false, we drop it as a backbone candidate.
 
-static bool filter_candidate (int idx) {
-  assert (!no_filter);
-  int lit = candidates[idx];
+// The model values of the remaining candidates of one word of the mask are
+// gathered into a word too.  Then the refuted candidates are those where
+// the model differs from the polarity of the candidates.
+
+static uint64_t model_word (CaDiCaL::Solver *solver, int word,
+                            uint64_t mask) {
+  uint64_t res = 0;
+  while (mask) {
+    const int bit = __builtin_ctzll (mask);
+    mask &= mask - 1;
+    if (solver->val (64 * word + bit) > 0) // Legacy support.
+      res |= (uint64_t) 1 << bit;
+  }
+  return res;
+}
+
+static uint64_t refuted_word (CaDiCaL::Solver *solver, int word,
+                              uint64_t mask) {
+  return mask & (model_word (solver, word, mask) ^ positive[word]);
+}
+
+// Drop the refuted candidates of the given word in the variable range from
+// 'start' to 'end'.
+
+static void filter_word (Worker *worker, int word, int start, int end) {
+  uint64_t mask = candidate_word (word);
+  if (64 * word < start)
+    mask &= ~(uint64_t) 0 << (start & 63);
+  if (64 * word + 63 > end)
+    mask &= ((uint64_t) 2 << (end & 63)) - 1;
+  if (!mask)
+    return;
+  uint64_t refuted = refuted_word (worker->solver, word, mask);
+  while (refuted) {
+    const int idx = 64 * word + __builtin_ctzll (refuted);
+    refuted &= refuted - 1;
+    const int lit = candidate (idx);
+    if (!drop_candidate (worker, idx))
+      continue;
+    dbg ("model also satisfies negation %d "
+         "of backbone candidate %d thus dropped %d",
+         -lit, lit, lit);
+    worker->statistics.filtered++;
+  }
+}
+
+static void filter_range (Worker *worker, int start, int end) {
+  for (int word = start >> 6; start <= end && word <= end >> 6; word++)
+    filter_word (worker, word, start, end);
+}
+
+// Put the values of the remaining candidates in the current model into the
+// cache of the worker, replacing the oldest model if the cache is full.
+// As candidates are only removed these values are all we need later.
+
+static void cache_model (Worker *worker) {
+  if (!candidates)
+    return; // First model.
+  const int words = (vars >> 6) + 1;
+  if (worker->cache.size () < (size_t) cache)
+    worker->cache.push_back (std::vector<uint64_t> (words));
+  std::vector<uint64_t> &values =
+      worker->cache[worker->cached++ % worker->cache.size ()];
+  for (int word = 0; word != words; word++)
+    values[word] = model_word (worker->solver, word, candidate_word (word));
+}
+
+// Drop the candidate if one of the cached models refutes it.
+
+static bool drop_cached_candidate (Worker *worker, int idx) {
+  const int lit = candidate (idx);
   if (!lit)
     return false;
-  int val = solver->val (idx) < 0 ? -idx : idx; // Legacy support.
-  assert (val == idx || val == -idx);
-  if (lit == val)
-    return false;
-  assert (lit == -val);
-  dbg ("model also satisfies negation %d "
-       "of backbone candidate %d thus dropping %d",
-       -lit, lit, lit);
-  statistics.filtered++;
-  drop_candidate (idx);
-  return true;
+  const uint64_t bit = candidate_bit (idx);
+  const uint64_t polarity = (lit > 0) ? bit : 0;
+  for (const auto &values : worker->cache) {
+    if ((values[idx >> 6] & bit) == polarity)
+      continue;
+    if (!drop_candidate (worker, idx))
+      return false;
+    dbg ("cached model refutes backbone candidate %d", lit);
+    worker->statistics.cached++;
+    return true;
+  }
+  return false;
 }
 
 // Try dropping as many variables as possible from 'start' to 'vars' based
-// on the value of the remaining candidates in the current model.
+// on the value of the remaining candidates in the current model (and as
+// for flipping also those before the slice of the worker).
 
-static void filter_candidates (int start) {
+static void filter_candidates (Worker *worker, int start) {
 
-  if (no_filter || start > vars)
+  if (no_filter)
     return;
 
-  unsigned res = 0;
-  for (int idx = start; idx <= vars; idx++)
-    if (filter_candidate (idx), !res)
-      res++;
-
-  assert (res);
-  (void) res;
+  filter_range (worker, start, vars);
+  filter_range (worker, 1, worker->begin - 1);
 }
 
 // Drop the first candidate refuted by the current model and drop it.  In
@@ -657,89 +2023,601 @@ static void filter_candidates (int start) {
 // model from the additional ones filtered by the model both with respect to
 // statistics as well as supporting '--no-filter'.
 
-static int drop_first_candidate (int start) {
-  assert (start <= vars);
-  int idx = start, lit = 0, val = 0;
-  for (;; idx++) {
-    assert (idx <= vars);
-    lit = candidates[idx];
-    if (!lit)
-      continue;
-    val = solver->val (idx) < 0 ? -idx : idx; // Legacy support.
-    assert (val == idx || val == -idx);
-    if (lit == -val)
-      break;
-  }
-  assert (lit);
-  assert (lit == -val);
-  assert (idx <= vars);
-  assert (candidates[idx] == lit);
+// With '--threads' the refuted candidates of the constraint might have
+// been dropped by other workers while solving.  Then no candidate is found
+// in the slice and we return zero.  The search starts at position 'start'
+// of the slice, which with '--order' is not the same as the variable.
+
+static bool drop_refuted_candidate (Worker *worker, int idx) {
+  int lit = candidate (idx);
+  if (!lit)
+    return false;
+  int val = worker->solver->val (idx) < 0 ? -idx : idx; // Legacy support.
+  assert (val == idx || val == -idx);
+  if (lit != -val)
+    return false;
+  if (!drop_candidate (worker, idx))
+    return false;
   dbg ("model satisfies negation %d "
-       "of backbone candidate %d thus dropping %d",
+       "of backbone candidate %d thus dropped %d",
        -lit, lit, lit);
-  drop_candidate (idx);
-  return idx;
+  return true;
+}
+
+static int drop_first_candidate (Worker *worker, int start) {
+  assert (start <= worker->end);
+  const int end = worker->end;
+  if (permutation) {
+    for (int pos = start; pos <= end; pos++)
+      if (drop_refuted_candidate (worker, permutation[pos]))
+        return permutation[pos];
+  } else
+    for (int idx = next_candidate (start, end); idx <= end;
+         idx = next_candidate (idx + 1, end))
+      if (drop_refuted_candidate (worker, idx))
+        return idx;
+  assert (threads > 1);
+  return 0;
+}
+
+// The candidates of the slice of the worker before position 'pos' are
+// already determined.  Filtering and flipping thus only needs to start at
+// the variable at that position unless the slice is permuted.
+
+static int remaining (Worker *worker, int pos) {
+  return permutation ? worker->begin : pos;
+}
+
+// Search for additional diverse models as described above for '--models'.
+// Phases not forced by '--set-phase' are reset afterwards.
+
+static void diversify_models (Worker *worker) {
+
+  if (!models)
+    return;
+
+  CaDiCaL::Solver *solver = worker->solver;
+  std::vector<int> phased;
+  for (int idx = next_candidate (1, vars); idx <= vars;
+       idx = next_candidate (idx + 1, vars)) {
+    solver->phase (-candidate (idx));
+    phased.push_back (idx);
+  }
+
+  for (int round = 0; round != models && remaining_candidates (); round++) {
+    const size_t before = worker->statistics.dropped;
+    solver->limit ("conflicts", models_conflict_limit);
+    if (trace)
+      finish_trace_event (worker);
+    const TraceClock clock = trace_clock ();
+    start_timer (&models_time);
+    assume_assumptions (solver);
+    int res = solver->solve ();
+    worker->satisfied = (res == 10);
+    worker->witness = -1;
+    stop_timer ();
+    if (trace)
+      trace_worker_call (worker, "models", 0, res, clock);
+    if (res == 10 && cache)
+      cache_model (worker);
+    worker->statistics.calls.models++;
+    if (res != 10) {
+      dbg ("no additional model found in round %d", round + 1);
+      break;
+    }
+    if (!no_filter)
+      filter_range (worker, 1, vars);
+    try_to_flip_remaining (worker, worker->begin);
+    if (worker->statistics.dropped == before) {
+      dbg ("additional model in round %d does not drop candidates",
+           round + 1);
+      break;
+    }
+  }
+
+  if (!set_phase)
+    for (auto idx : phased)
+      solver->unphase (idx);
 }
 
 // Assume the given variable is a backbone variable with its candidate
 // literal as backbone literal.  Optionally print, check and count it.
 
-static bool backbone_variable (int idx) {
-  int lit = candidates[idx];
-  if (!lit)
+static bool single_backbone_variable (Worker *worker, int idx) {
+  int lit = candidate (idx);
+  if (!lit || !remove_candidate (idx, lit))
     return false;
-  fixed[idx] = lit;
-  candidates[idx] = 0;
-  if (!no_print) {
-    fprintf (files.backbone.file, "b %d\n", lit);
-    fflush (files.backbone.file);
-  }
+  fix_literal (lit);
+  lock_shared ();
+  output_backbone (lit);
+  reach_backbone_milestone ();
+  if (threads > 1)
+    units.push_back (lit);
+  unlock_shared ();
   if (checker)
-    check_backbone (lit);
-  assert (statistics.backbones < (size_t) vars);
-  statistics.backbones++;
+    check_backbone (worker, lit);
+  assert (worker->statistics.backbones < (size_t) vars);
+  worker->statistics.backbones++;
+  return true;
+}
+
+// Also all equivalent variables are backbones then.
+
+static bool backbone_variable (Worker *worker, int idx) {
+  if (!single_backbone_variable (worker, idx))
+    return false;
+  if (!equivalences.empty ())
+    for (int other = equivalences[idx]; other && other != idx;
+         other = equivalences[other])
+      if (single_backbone_variable (worker, other))
+        worker->statistics.equivalent++;
   return true;
 }
 
-static bool fix_candidate (int idx) {
+static bool fix_candidate (Worker *worker, int idx) {
 
   assert (!no_fixed);
-  int lit = candidates[idx];
-  assert (lit);
+  int lit = candidate (idx);
+  if (!lit) {
+    assert (threads > 1); // Dropped by other worker.
+    return true;
+  }
 
-  int tmp = solver->fixed (lit);
+  int tmp = worker->solver->fixed (lit);
   if (!tmp)
     return false;
 
   if (tmp > 0) {
     dbg ("found fixed backbone %d", lit);
-    backbone_variable (idx);
+    backbone_variable (worker, idx);
   }
 
   if (tmp < 0) {
     dbg ("removing fixed backbone %d candidate", lit);
-    drop_candidate (idx);
+    drop_candidate (worker, idx);
   }
 
-  statistics.fixed++;
+  worker->statistics.fixed++;
   return true;
 }
 
 // Force all variables from 'start' to 'vars' to be backbones unless they
 // were already dropped.  This is used for 'constrain'.
 
-static void backbone_variables (int assumed) {
+static void backbone_variables (Worker *worker, int assumed) {
   int count = 0;
   for (int i = 0; i != assumed; i++) {
-    int lit = constraint[i];
+    int lit = worker->constraint[i];
     int idx = abs (lit);
-    if (backbone_variable (idx))
+    if (backbone_variable (worker, idx))
       count++;
   }
   assert (count);
   (void) count;
 }
 
+// Add the backbones found by other workers as units to the solver of this
+// worker, which is only necessary with '--threads'.
+
+static void import_units (Worker *worker) {
+  if (threads == 1)
+    return;
+  if (!worker->id && !assumptions.empty ())
+    return; // Backbones under assumptions are not units of the formula.
+  CaDiCaL::Solver *solver = worker->solver;
+  lock_shared ();
+  while (worker->imported < units.size ()) {
+    int lit = units[worker->imported++];
+    solver->add (lit);
+    solver->add (0);
+    worker->satisfied = false;
+  }
+  unlock_shared ();
+}
+
+// Failed literal probing for '--probe' after the first model.  The negation
+// of each remaining candidate literal is propagated with full unit
+// propagation over a copy of the irredundant clauses (and the root-level
+// units and assumptions).  If this leads to a conflict the candidate is a
+// backbone, which is then also added as root-level unit.  Propagation uses
+// two watched literals in the first two positions of each clause.
+
+// A propagation which does not fail is not a model and thus can not drop
+// candidates.  Clauses over variables beyond 'vars' (activation literals)
+// are skipped, which is sound as probing only needs implied clauses.
+
+struct Prober {
+  std::vector<int> literals;                // Zero terminated clauses.
+  std::vector<std::vector<size_t>> watches; // Watched clauses per node.
+  std::vector<signed char> values;          // Per node 'ind (lit)'.
+  std::vector<int> trail;                   // Assigned literals.
+  size_t propagated;                        // Propagated on 'trail'.
+  uint64_t ticks;                           // Visited watches.
+};
+
+class ProbeClauseCopier : public CaDiCaL::ClauseIterator {
+public:
+  Prober &prober;
+  size_t clauses = 0;
+  std::vector<int> units;
+  ProbeClauseCopier (Prober &prober) : prober (prober) {}
+  bool clause (const std::vector<int> &c) {
+    for (auto lit : c)
+      if (abs (lit) > vars)
+        return true;
+    if (c.size () == 1) {
+      units.push_back (c[0]);
+      return true;
+    }
+    const size_t start = prober.literals.size ();
+    for (auto lit : c)
+      prober.literals.push_back (lit);
+    prober.literals.push_back (0);
+    prober.watches[ind (c[0])].push_back (start);
+    prober.watches[ind (c[1])].push_back (start);
+    clauses++;
+    return true;
+  }
+};
+
+static signed char probe_value (Prober &prober, int lit) {
+  return prober.values[ind (lit)];
+}
+
+static void probe_assign (Prober &prober, int lit) {
+  assert (!probe_value (prober, lit));
+  prober.values[ind (lit)] = 1;
+  prober.values[ind (-lit)] = -1;
+  prober.trail.push_back (lit);
+}
+
+// Returns 'false' on a conflict (the watches are kept consistent).
+
+static bool probe_propagate (Prober &prober) {
+  bool ok = true;
+  while (ok && prober.propagated != prober.trail.size ()) {
+    const int lit = -prober.trail[prober.propagated++];
+    std::vector<size_t> &ws = prober.watches[ind (lit)];
+    size_t i = 0, j = 0;
+    while (i != ws.size ()) {
+      const size_t c = ws[j++] = ws[i++];
+      int *literals = &prober.literals[c];
+      prober.ticks++;
+      if (!ok)
+        continue;
+      if (literals[0] == lit)
+        std::swap (literals[0], literals[1]);
+      assert (literals[1] == lit);
+      const int other = literals[0];
+      if (probe_value (prober, other) > 0)
+        continue;
+      int *k = literals + 2;
+      while (*k && probe_value (prober, *k) < 0)
+        k++;
+      if (*k) {
+        std::swap (literals[1], *k);
+        prober.watches[ind (literals[1])].push_back (c);
+        j--;
+      } else if (!probe_value (prober, other))
+        probe_assign (prober, other);
+      else
+        ok = false;
+    }
+    ws.resize (j);
+  }
+  return ok;
+}
+
+static void probe_backtrack (Prober &prober, size_t level) {
+  while (prober.trail.size () > level) {
+    const int lit = prober.trail.back ();
+    prober.values[ind (lit)] = prober.values[ind (-lit)] = 0;
+    prober.trail.pop_back ();
+  }
+  prober.propagated = level;
+}
+
+// The propagation effort is bounded by this factor times the number of
+// literals in the copied clauses (plus one such pass).
+
+static const uint64_t probe_effort = 10;
+
+static void probe_candidates (Worker *worker) {
+
+  if (!probe)
+    return;
+
+  start_timer (&probe_time);
+
+  Prober prober;
+  prober.watches.resize (2 * (size_t) vars);
+  prober.values.resize (2 * (size_t) vars);
+  prober.propagated = 0;
+  prober.ticks = 0;
+
+  ProbeClauseCopier copier (prober);
+  solver->traverse_clauses (copier);
+  for (int idx = 1; idx <= vars; idx++)
+    if (solver->fixed (idx))
+      copier.units.push_back (solver->fixed (idx) < 0 ? -idx : idx);
+  for (int idx = 1; idx <= vars; idx++)
+    if (fixed_literal (idx))
+      copier.units.push_back (fixed_literal (idx));
+  for (auto lit : assumptions)
+    copier.units.push_back (lit);
+  for (auto lit : copier.units)
+    if (!probe_value (prober, lit))
+      probe_assign (prober, lit);
+  const bool consistent = probe_propagate (prober);
+  assert (consistent); // As the first model satisfies all of these.
+  (void) consistent;
+  const size_t root = prober.trail.size ();
+
+  const uint64_t limit = probe_effort * (prober.literals.size () + 1);
+  msg ("probing candidates on %zu copied clauses", copier.clauses);
+
+  size_t probed = 0, failed = 0;
+  for (int idx = next_candidate (range.begin, range.end);
+       idx <= range.end && prober.ticks <= limit;
+       idx = next_candidate (idx + 1, range.end)) {
+    const int lit = candidate (idx);
+    if (!lit || probe_value (prober, lit))
+      continue;
+    const size_t level = prober.trail.size ();
+    probe_assign (prober, -lit);
+    probed++;
+    const bool ok = probe_propagate (prober);
+    probe_backtrack (prober, level);
+    if (ok)
+      continue;
+    dbg ("failed literal %d", -lit);
+    probe_assign (prober, lit);
+    const bool implied = probe_propagate (prober);
+    assert (implied);
+    (void) implied;
+    failed++;
+  }
+  stop_timer ();
+  msg ("probed %zu candidates with %zu failed literals", probed, failed);
+
+  // All literals on the trail after the initial root-level units follow
+  // from failed literals (thus are backbones too) and are only reported
+  // now, since checking them is timed separately.
+
+  for (size_t i = root; i != prober.trail.size (); i++) {
+    const int lit = prober.trail[i];
+    const int idx = abs (lit);
+    if (idx < range.begin || idx > range.end || candidate (idx) != lit)
+      continue;
+    if (backbone_variable (worker, idx))
+      worker->statistics.probed++;
+  }
+}
+
+// Run 'job (0)' to 'job (jobs - 1)' in parallel, the first on the calling
+// thread.
+
+template <typename Job> static void run_jobs (int jobs, Job job) {
+  std::vector<std::thread> running;
+  for (int j = 1; j < jobs; j++)
+    running.push_back (std::thread (job, j));
+  job (0);
+  for (auto &thread : running)
+    thread.join ();
+}
+
+#ifndef NMAIN
+
+// For large uncompressed DIMACS files the character by character parsing
+// in 'CaDiCaL' can take a substantial part of the running time.  Instead
+// we map the file into memory, split it after the header into one chunk
+// per job at line boundaries and parse the chunks in parallel into flat
+// literal buffers with zero terminated clauses.  A clause might span two
+// chunks but then the buffers simply need to be added in order.
+
+struct Chunk {
+  const char *begin, *end; // Characters of the chunk.
+  std::vector<int> literals;
+  size_t clauses;    // Number of zero terminated clauses.
+  const char *error; // First parse error (if any).
+  const char *error_position;
+};
+
+static void parse_chunk (Chunk &chunk, int max_var) {
+  const char *p = chunk.begin, *end = chunk.end;
+  bool line_start = true;
+  chunk.clauses = 0;
+  chunk.error = 0;
+  while (p != end) {
+    int ch = *p;
+    if (line_start && ch == 'c') {
+      while (p != end && *p != '\n')
+        p++;
+      continue;
+    }
+    if (ch == '\n') {
+      line_start = true, p++;
+      continue;
+    }
+    line_start = false;
+    if (ch == ' ' || ch == '\t' || ch == '\r') {
+      p++;
+      continue;
+    }
+    const char *start = p;
+    int sign = 1;
+    if (ch == '-') {
+      sign = -1;
+      if (++p == end || !isdigit (*p)) {
+        chunk.error = "expected digit after '-'";
+        chunk.error_position = start;
+        return;
+      }
+    } else if (!isdigit (ch)) {
+      chunk.error = "unexpected character";
+      chunk.error_position = start;
+      return;
+    }
+    int idx = 0;
+    while (p != end && isdigit ((ch = *p))) {
+      const int digit = ch - '0';
+      if (INT_MAX / 10 < idx || INT_MAX - digit < 10 * idx) {
+        chunk.error = "literal too large";
+        chunk.error_position = start;
+        return;
+      }
+      idx = 10 * idx + digit;
+      p++;
+    }
+    if (idx > max_var) {
+      chunk.error = "literal exceeds maximum variable in header";
+      chunk.error_position = start;
+      return;
+    }
+    if (sign < 0 && !idx) {
+      chunk.error = "negative zero literal";
+      chunk.error_position = start;
+      return;
+    }
+    chunk.literals.push_back (sign * idx);
+    if (!idx)
+      chunk.clauses++;
+  }
+}
+
+static const char *parse_error (const char *path, const char *begin,
+                                const char *position, const char *what) {
+  static char buffer[256];
+  size_t line = 1;
+  for (const char *p = begin; p != position; p++)
+    if (*p == '\n')
+      line++;
+  snprintf (buffer, sizeof buffer, "%s in line %zu of '%s'", what, line,
+            path);
+  return buffer;
+}
+
+// Parse the header after leading comment lines.  The result points right
+// after the header line (or is zero on error).
+
+static const char *parse_header (const char *p, const char *end,
+                                 int &max_var, size_t &clauses) {
+  while (p != end && *p == 'c')
+    while (p != end && *p++ != '\n')
+      ;
+  if (end - p < 6 || strncmp (p, "p cnf ", 6))
+    return 0;
+  long long v = -1, c = -1;
+  char line[128];
+  const char *eol = p;
+  while (eol != end && *eol != '\n')
+    eol++;
+  if (eol - p >= (long) sizeof line)
+    return 0;
+  memcpy (line, p, eol - p);
+  line[eol - p] = 0;
+  char tail;
+  if (sscanf (line, "p cnf %lld %lld %c", &v, &c, &tail) != 2)
+    return 0;
+  if (v < 0 || v > INT_MAX || c < 0)
+    return 0;
+  max_var = v;
+  clauses = c;
+  return eol == end ? eol : eol + 1;
+}
+
+// Returns 'false' if the file can not be mapped, looks compressed or does
+// not strictly follow the format expected here, in which case it should
+// be read by 'CaDiCaL', which accepts more (relaxed) input and reports the
+// actual parse errors.  Nothing is added to the solver in that case.
+
+static bool read_mapped_dimacs (const char *path, int &vars) {
+  const char *err = 0;
+  int fd = open (path, O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat st;
+  if (fstat (fd, &st) || !S_ISREG (st.st_mode) || !st.st_size) {
+    close (fd);
+    return false;
+  }
+  const size_t size = st.st_size;
+  void *mapped = mmap (0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (mapped == MAP_FAILED)
+    return false;
+  const char *begin = (const char *) mapped, *end = begin + size;
+  if (*begin != 'c' && *begin != 'p') { // Compressed (or invalid).
+    munmap (mapped, size);
+    return false;
+  }
+  madvise (mapped, size, MADV_SEQUENTIAL);
+
+  int max_var;
+  size_t expected;
+  const char *body = parse_header (begin, end, max_var, expected);
+  if (!body) {
+    msg ("falling back to parsing by the solver (unexpected header)");
+    munmap (mapped, size);
+    return false;
+  }
+
+  const size_t min_bytes_per_job = 1 << 20;
+  const int jobs =
+      std::min ((size_t) threads, (end - body) / min_bytes_per_job + 1);
+  std::vector<Chunk> chunks (jobs);
+  const char *p = body;
+  for (int j = 0; j != jobs; j++) {
+    chunks[j].begin = p;
+    if (j + 1 == jobs)
+      p = end;
+    else {
+      p = body + (end - body) * (j + 1) / jobs;
+      if (p < chunks[j].begin)
+        p = chunks[j].begin;
+      while (p != end && p[-1] != '\n')
+        p++;
+    }
+    chunks[j].end = p;
+  }
+
+  run_jobs (jobs, [&] (int j) { parse_chunk (chunks[j], max_var); });
+
+  size_t clauses = 0;
+  int last = 0;
+  for (auto &chunk : chunks) {
+    if (chunk.error) {
+      err = parse_error (path, begin, chunk.error_position, chunk.error);
+      break;
+    }
+    clauses += chunk.clauses;
+    if (!chunk.literals.empty ())
+      last = chunk.literals.back ();
+  }
+  if (!err && last)
+    err = parse_error (path, begin, end, "last clause without '0'");
+  if (!err && clauses != expected) {
+    static char buffer[128];
+    snprintf (buffer, sizeof buffer,
+              "found %zu clauses but header specifies %zu", clauses,
+              expected);
+    err = parse_error (path, begin, end, buffer);
+  }
+  if (!err) {
+    solver->reserve (max_var);
+    for (auto &chunk : chunks) {
+      for (int lit : chunk.literals)
+        solver->add (lit);
+      std::vector<int> ().swap (chunk.literals);
+    }
+    vars = max_var;
+    msg ("parsed %zu clauses in %d memory mapped chunks", clauses, jobs);
+  } else
+    msg ("falling back to parsing by the solver (%s)", err);
+  munmap (mapped, size);
+  return !err;
+}
+
 // Want to make sure not to overwrite accidentally (without '--force') files
 // which look like CNF files (as this happened to me all the time).
 
@@ -777,70 +2655,122 @@ static bool looks_like_a_dimacs_file (const char *path) {
          match_until_dot (suffix, "cnf");
 }
 
-int ind (int i) {
-  assert (i);
-  return (abs (i) << 1) - 1 - (i > 0);
-}
-int lit (int i) { return ((i >> 1) + 1) * ((i & 1) ? -1 : 1); }
-int var (int i) { return (i >> 1) + 1; }
-int neg (int i) { return i ^ 1; }
+#endif
 
-class BigDegreeIterator : public CaDiCaL::ClauseIterator {
+// The binary clauses of the solver are collected in one pass as pairs of
+// nodes and then turned into the compressed sparse row representation of
+// the BIG, with 'f[u]' the offset of the edges of node 'u' in 'e'.
+
+class BigBinaryIterator : public CaDiCaL::ClauseIterator {
 public:
-  int num_edges = 0;
-  std::vector<int> &f;
-  BigDegreeIterator (std::vector<int> &f) : f (f) {}
+  std::vector<int> &binaries;
+  BigBinaryIterator (std::vector<int> &binaries) : binaries (binaries) {}
   bool clause (const std::vector<int> &c) {
     if (c.size () != 2)
       return true;
-    num_edges += 2;
-    ++f[neg (ind (c[0])) + 2];
-    ++f[neg (ind (c[1])) + 2];
+    binaries.push_back (ind (c[0]));
+    binaries.push_back (ind (c[1]));
     return true;
   }
 };
 
-class BigEdgeIterator : public CaDiCaL::ClauseIterator {
-public:
-  std::vector<int> &f, &e;
-  BigEdgeIterator (std::vector<int> &f, std::vector<int> &e)
-      : f (f), e (e) {}
-  bool clause (const std::vector<int> &c) {
-    if (c.size () != 2)
-      return true;
-    const int u = ind (c[0]);
-    const int v = ind (c[1]);
-    e[f[neg (u) + 1]++] = v;
-    e[f[neg (v) + 1]++] = u;
-    return true;
-  }
-};
+// With '--threads' the BIG algorithms split their work among that many
+// jobs, but only if there is enough work for each job.
+
+static int big_jobs (size_t size) {
+  const size_t min_size_per_job = 100000;
+  return std::min ((size_t) threads, size / min_size_per_job + 1);
+}
+
+// With several jobs the degrees are counted, the offsets computed and the
+// edges scattered in parallel.  Each job counts the edges of its own
+// part of the binary clauses per node and then scatters them into its own
+// range of the edges of each node.  Thus the edges end up in the same
+// order as if computed by a single job.
 
 static void big_extract (int num_nodes, std::vector<int> &f,
                          std::vector<int> &e) {
-  f.resize (num_nodes + 2);
-  BigDegreeIterator fillF (f);
-  solver->traverse_clauses (fillF);
-  e.resize (fillF.num_edges);
-  for (size_t i = 1; i < f.size (); i++)
-    f[i] += f[i - 1];
-  BigEdgeIterator fillE (f, e);
-  solver->traverse_clauses (fillE);
-  f.pop_back ();
+  std::vector<int> binaries;
+  BigBinaryIterator collect (binaries);
+  solver->traverse_clauses (collect);
+  const size_t num_binaries = binaries.size () / 2;
+
+  const int jobs = big_jobs (num_binaries);
+  const auto first_binary = [&] (int j) {
+    return num_binaries * j / jobs;
+  };
+  const auto first_node = [&] (int j) {
+    return (int) ((long long) num_nodes * j / jobs);
+  };
+
+  std::vector<std::vector<int>> count (jobs);
+  run_jobs (jobs, [&] (int j) {
+    std::vector<int> &c = count[j];
+    c.resize (num_nodes);
+    for (size_t i = first_binary (j); i != first_binary (j + 1); i++) {
+      c[neg (binaries[2 * i])]++;
+      c[neg (binaries[2 * i + 1])]++;
+    }
+  });
+
+  // Parallel prefix sum over the nodes split into one range per job.  First
+  // each job sums up the edges in its range of nodes, then the offsets of
+  // the ranges are computed and finally each job computes the offsets of
+  // its nodes and turns the counts into the offsets for scattering.
+
+  std::vector<size_t> part (jobs + 1);
+  run_jobs (jobs, [&] (int j) {
+    size_t sum = 0;
+    for (int u = first_node (j); u != first_node (j + 1); u++)
+      for (int k = 0; k != jobs; k++)
+        sum += count[k][u];
+    part[j + 1] = sum;
+  });
+  for (int j = 0; j != jobs; j++)
+    part[j + 1] += part[j];
+  assert (part[jobs] == 2 * num_binaries);
+
+  f.resize (num_nodes + 1);
+  f[num_nodes] = part[jobs];
+  run_jobs (jobs, [&] (int j) {
+    int offset = part[j];
+    for (int u = first_node (j); u != first_node (j + 1); u++) {
+      f[u] = offset;
+      for (int k = 0; k != jobs; k++) {
+        const int edges = count[k][u];
+        count[k][u] = offset;
+        offset += edges;
+      }
+    }
+  });
+
+  e.resize (2 * num_binaries);
+  run_jobs (jobs, [&] (int j) {
+    std::vector<int> &next = count[j];
+    for (size_t i = first_binary (j); i != first_binary (j + 1); i++) {
+      const int u = binaries[2 * i];
+      const int v = binaries[2 * i + 1];
+      e[next[neg (u)]++] = v;
+      e[next[neg (v)]++] = u;
+    }
+  });
+
   assert (f.size () == static_cast<size_t> (num_nodes + 1));
-  msg ("read BIG with %d nodes and %d edges", num_nodes, fillF.num_edges);
+  msg ("read BIG with %d nodes and %zu edges", num_nodes, e.size ());
 }
 
-static int big_els (std::vector<int> &f, std::vector<int> &e,
-                    std::vector<int> &extension, bool check_only = false) {
-  if (e.empty ())
-    return 0;
+// Determine the representative of the strongly connected component of
+// each node in the BIG, which is the smallest node in the component.
+// Returns '20' if a literal and its negation end up in the same component.
+
+static int big_tarjan (const std::vector<int> &f, const std::vector<int> &e,
+                       std::vector<unsigned> &rep) {
   // tarjan
   const unsigned INV = UINT_MAX;
   // using MSB as closed flag
   const unsigned MSB = 1 << (sizeof (unsigned) * 8 - 1);
   const int n = f.size () - 1;
-  std::vector<unsigned> rep (n, INV);
+  rep.assign (n, INV);
   std::vector<int> work, scc;
   unsigned i = 0;
   for (int u = 0; u < n; u++) {
@@ -897,91 +2827,238 @@ static int big_els (std::vector<int> &f, std::vector<int> &e,
                   [] (int x) { return x ^ MSB; });
   assert (std::all_of (rep.begin (), rep.end (),
                        [] (unsigned n) { return n < MSB; }));
+  return 0;
+}
+
+// Parallel alternative to Tarjan's algorithm used with several jobs.  First
+// components of size one are trimmed, which are nodes without incoming or
+// outgoing edges to remaining nodes (in the BIG the predecessors of 'u' are
+// the negations of the successors of 'neg (u)').  Then the remaining nodes
+// are colored by propagating the largest node reaching them in parallel.
+// The nodes of each color which reach that largest node backward form a
+// component.  Those are removed and the coloring is repeated for the rest.
+
+static int big_coloring (int jobs, const std::vector<int> &f,
+                         const std::vector<int> &e,
+                         std::vector<unsigned> &rep) {
+  const unsigned INV = UINT_MAX;
+  const int n = f.size () - 1;
+  rep.assign (n, INV);
+
+  std::vector<int> in (n), out (n), trivial;
+  for (int u = 0; u < n; u++) {
+    out[u] = f[u + 1] - f[u];
+    for (int k = f[u]; k < f[u + 1]; k++)
+      in[e[k]]++;
+  }
+  for (int u = 0; u < n; u++)
+    if (!in[u] || !out[u])
+      trivial.push_back (u);
+  while (!trivial.empty ()) {
+    const int u = trivial.back ();
+    trivial.pop_back ();
+    if (rep[u] != INV)
+      continue;
+    rep[u] = u;
+    for (int k = f[u]; k < f[u + 1]; k++) {
+      const int v = e[k];
+      if (rep[v] == INV && !--in[v])
+        trivial.push_back (v);
+    }
+    for (int k = f[neg (u)]; k < f[neg (u) + 1]; k++) {
+      const int w = neg (e[k]);
+      if (rep[w] == INV && !--out[w])
+        trivial.push_back (w);
+    }
+  }
+
+  std::vector<int> remaining;
+  for (int u = 0; u < n; u++)
+    if (rep[u] == INV)
+      remaining.push_back (u);
+
+  std::vector<std::atomic<int>> color (n);
+  while (!remaining.empty ()) {
+    const size_t size = remaining.size ();
+    const auto first = [&] (int j) { return size * j / jobs; };
+    for (int u : remaining)
+      color[u] = u;
+    std::atomic<bool> changed;
+    do {
+      changed = false;
+      run_jobs (jobs, [&] (int j) {
+        for (size_t i = first (j); i != first (j + 1); i++) {
+          const int u = remaining[i];
+          const int c = color[u].load (std::memory_order_relaxed);
+          for (int k = f[u]; k < f[u + 1]; k++) {
+            const int v = e[k];
+            if (rep[v] != INV)
+              continue;
+            int d = color[v].load (std::memory_order_relaxed);
+            while (d < c && !color[v].compare_exchange_weak (
+                                d, c, std::memory_order_relaxed))
+              ;
+            if (d < c)
+              changed = true;
+          }
+        }
+      });
+    } while (changed);
+
+    std::vector<int> roots;
+    for (int u : remaining)
+      if (color[u] == u)
+        roots.push_back (u);
+
+    run_jobs (jobs, [&] (int j) {
+      const size_t size = roots.size ();
+      std::vector<int> component;
+      for (size_t i = size * j / jobs; i != size * (j + 1) / jobs; i++) {
+        const int root = roots[i];
+        component = {root};
+        rep[root] = root;
+        for (size_t l = 0; l < component.size (); l++) {
+          const int v = neg (component[l]);
+          for (int k = f[v]; k < f[v + 1]; k++) {
+            const int w = neg (e[k]);
+            if (color[w] != root || rep[w] != INV)
+              continue;
+            rep[w] = root;
+            component.push_back (w);
+          }
+        }
+        const int min_node =
+            *std::min_element (component.begin (), component.end ());
+        for (int u : component)
+          rep[u] = min_node;
+      }
+    });
+
+    size_t j = 0;
+    for (int u : remaining)
+      if (rep[u] == INV)
+        remaining[j++] = u;
+    remaining.resize (j);
+  }
+
+  for (int u = 0; u < n; u++)
+    if (rep[u] == rep[neg (u)])
+      return 20; // unsatisfiable
+  return 0;
+}
+
+static int big_els (std::vector<int> &f, std::vector<int> &e,
+                    std::vector<int> &extension, bool check_only = false) {
+  if (e.empty ())
+    return 0;
+  const int n = f.size () - 1;
+  std::vector<unsigned> rep;
+  const int jobs = big_jobs (e.size ());
+  int res = jobs > 1 ? big_coloring (jobs, f, e, rep)
+                     : big_tarjan (f, e, rep);
+  if (res)
+    return res;
 
   if (check_only)
     return 0;
-  // sort (stable) node indices by their rep
-  std::vector<int> sccs (n);
-  std::iota (sccs.begin (), sccs.end (), 0);
-  std::stable_sort (sccs.begin (), sccs.end (),
-                    [&] (int a, int b) { return rep[a] < rep[b]; });
-
-  // substitute
-  int r = -1, u_prime = -1, l = 0;
-  std::vector<int> f_prime (n + 1), e_prime, edges;
-  e_prime.reserve (n);
-  for (int u : sccs) {
-    int r_prime = rep[u];
-    if (r_prime != r) {
-      if (l) {
-        l = 0;
-        extension.push_back (-1);
-      } else if (r != -1)
-        extension.pop_back ();
-      r = r_prime;
-      for (int v : edges) {
-        marked[v] = false;
-        e_prime.push_back (v);
-      }
-      assert (static_cast<size_t> (u_prime + 1) < f_prime.size ());
-      f_prime.at (u_prime + 1) = edges.size (); // needs prefix sum
-      edges.clear ();
-      u_prime = r;
-    } else
-      l++;
-    extension.push_back (u);
-    assert (static_cast<int> (rep[u]) == r);
 
-    for (int i = f[u]; i < f[u + 1]; ++i) {
-      const int v = rep[e[i]];
-      if (v == r)
-        continue;
-      if (!marked[v]) {
-        edges.push_back (v);
-        marked[v] = true;
+  // Counting sort of the node indices by their representative, which keeps
+  // the nodes of each component in order and the representative first.
+  // The offsets are reused for the edge counts of the new graph below.
+
+  std::vector<int> sccs (n), offsets (n + 1);
+  for (int u = 0; u < n; u++)
+    offsets[rep[u] + 1]++;
+  for (int r = 0; r < n; r++)
+    offsets[r + 1] += offsets[r];
+  for (int u = 0; u < n; u++)
+    sccs[offsets[rep[u]]++] = u;
+
+  std::vector<int> groups;
+  for (int i = 0; i < n; i++)
+    if (!i || rep[sccs[i]] != rep[sccs[i - 1]])
+      groups.push_back (i);
+  const int num_groups = groups.size ();
+  groups.push_back (n);
+
+  // Substitute all nodes by their representative.  The edges of the
+  // representatives are collected by several jobs for their own range of
+  // components (with their own flags for merging duplicated edges) and
+  // then concatenated in the order of the components.
+
+  std::vector<int> &f_prime = offsets;
+  std::fill (f_prime.begin (), f_prime.end (), 0);
+  std::vector<std::vector<int>> edges (jobs);
+  run_jobs (jobs, [&] (int j) {
+    std::vector<char> merged (n);
+    const int first = (long long) num_groups * j / jobs;
+    const int last = (long long) num_groups * (j + 1) / jobs;
+    for (int g = first; g != last; g++) {
+      const int r = sccs[groups[g]];
+      assert (static_cast<int> (rep[r]) == r);
+      const size_t before = edges[j].size ();
+      for (int i = groups[g]; i != groups[g + 1]; i++) {
+        const int u = sccs[i];
+        for (int k = f[u]; k < f[u + 1]; ++k) {
+          const int v = rep[e[k]];
+          if (v == r || merged[v])
+            continue;
+          edges[j].push_back (v);
+          merged[v] = true;
+        }
       }
+      for (size_t i = before; i < edges[j].size (); i++)
+        merged[edges[j][i]] = false;
+      f_prime[r + 1] = edges[j].size () - before; // needs prefix sum
     }
-  }
-  if (l) {
-    l = 0;
+  });
+
+  // Groups of more than one literal are terminated by '-1'.
+
+  for (int g = 0; g != num_groups; g++) {
+    if (groups[g + 1] - groups[g] < 2)
+      continue;
+    for (int i = groups[g]; i != groups[g + 1]; i++)
+      extension.push_back (sccs[i]);
     extension.push_back (-1);
-  } else
-    extension.pop_back ();
-  if (edges.size ()) {
-    for (int v : edges) {
-      marked[v] = false;
-      e_prime.push_back (v);
-    }
-    f_prime[u_prime + 1] = edges.size (); // needs prefix sum
-    edges.clear ();
+  }
+
+  std::vector<unsigned> ().swap (rep);
+  std::vector<int> ().swap (sccs);
+  std::vector<int> ().swap (groups);
+
+  // Merging only removes edges.  Thus the new edges fit into the old ones
+  // and the edges of each job can be released after copying them.
+
+  e.clear ();
+  for (auto &job_edges : edges) {
+    e.insert (e.end (), job_edges.begin (), job_edges.end ());
+    std::vector<int> ().swap (job_edges);
   }
 
   for (size_t i = 1; i < f_prime.size (); i++)
     f_prime[i] += f_prime[i - 1];
 
   assert (f_prime.size () == static_cast<size_t> (n + 1));
-  assert (e_prime.size () == static_cast<size_t> (f_prime.back ()));
+  assert (e.size () == static_cast<size_t> (f_prime.back ()));
 
-  f = std::move (f_prime);
-  e = std::move (e_prime);
+  f.swap (f_prime);
   return 0;
 }
 
 static bool big_backbone_node (int node) {
   int literal = lit (node);
-  int idx = var (node);
   if (!literal)
     return false;
-  fixed[idx] = literal;
-  if (!no_print) {
-    fprintf (files.backbone.file, "b %d\n", literal);
-    fflush (files.backbone.file);
-  }
+  fix_literal (literal);
+  output_backbone (literal);
+  reach_backbone_milestone ();
   solver->add (literal);
   solver->add (0);
-  assert (statistics.backbones < (size_t) vars);
-  statistics.backbones++;
-  statistics.big_backbones++;
+  determined++;
+  assert (workers->statistics.backbones < (size_t) vars);
+  workers->statistics.backbones++;
+  workers->statistics.big_backbones++;
   return true;
 }
 
@@ -990,7 +3067,7 @@ static void big_backbone_base (const std::vector<int> &f,
   msg ("BIG base searching for backbones after %.2f seconds", time ());
   const int n = f.size () - 1;
   for (int c = 0; c < n; ++c) {
-    if (fixed[var (c)])
+    if (fixed_literal (var (c)))
       continue;
     marked[c] = true;
     std::vector<int> tree{c};
@@ -1028,7 +3105,7 @@ static bool big_propagate (const std::vector<int> &f,
       int v = e[j];
       if (marked[v])
         continue;
-      assert (!fixed[var (v)]);
+      assert (!fixed_literal (var (v)));
       if (marked[neg (v)])
         return true;
       marked[v] = true;
@@ -1063,7 +3140,7 @@ static void big_backbone (const std::vector<int> &f,
     for (auto i = j; i != end; i++) {
       const int save_tree = tree.size ();
       int c = *i;
-      if (fixed[var (c)] || marked[c])
+      if (fixed_literal (var (c)) || marked[c])
         continue;
       if (marked[neg (c)]) {
         *j++ = c; // delay candidate
@@ -1091,7 +3168,7 @@ static void big_backbone (const std::vector<int> &f,
             }
             for (int j = f[u]; j < f[u + 1]; ++j) {
               const int v = e[j];
-              if (fixed[var (v)])
+              if (fixed_literal (var (v)))
                 continue;
               big_backbone_node (v);
               backbones.push_back (v);
@@ -1102,25 +3179,2022 @@ static void big_backbone (const std::vector<int> &f,
         }
       }
     }
-    candidates.resize (j - candidates.begin ());
-    if (big_roots) {
-      candidates.insert (candidates.end (), new_candidates.begin (),
-                         new_candidates.end ());
-      new_candidates.clear ();
+    candidates.resize (j - candidates.begin ());
+    if (big_roots) {
+      candidates.insert (candidates.end (), new_candidates.begin (),
+                         new_candidates.end ());
+      new_candidates.clear ();
+    }
+    if (candidates.empty ())
+      break;
+    for (int u : tree)
+      marked[u] = false;
+    for (int u : backbones)
+      marked[u] = true;
+    backbones.clear ();
+    tree.clear ();
+  }
+}
+
+// After ELS the BIG is acyclic and we can compute a topological order of
+// its nodes, where each node comes before all its successors.
+
+static std::vector<int> big_topological_order (const std::vector<int> &f,
+                                               const std::vector<int> &e) {
+  const int n = f.size () - 1;
+  std::vector<int> in (n), order;
+  order.reserve (n);
+  for (int v : e)
+    in[v]++;
+  for (int u = 0; u < n; u++)
+    if (!in[u])
+      order.push_back (u);
+  for (size_t i = 0; i < order.size (); i++) {
+    const int u = order[i];
+    for (int k = f[u]; k < f[u + 1]; k++)
+      if (!--in[e[k]])
+        order.push_back (e[k]);
+  }
+  assert (order.size () == static_cast<size_t> (n));
+  return order;
+}
+
+// Transitive reduction of the acyclic BIG for '--big-reduce' restricted to
+// edges 'u -> w' for which there is another edge 'u -> v' and 'v -> w'.
+// By induction over the topological distance of 'u' and 'w' reachability is
+// preserved even if all these edges are removed at once.  The mirror edge
+// 'neg (w) -> neg (u)' is implied by 'neg (v)' in the same way and is
+// removed too, such that the BIG remains skew-symmetric (which is needed
+// for finding predecessors with '--big-roots').  The number of steps spent
+// in finding redundant edges is bounded relative to the number of edges.
+
+static void big_reduce_transitive (std::vector<int> &f,
+                                   std::vector<int> &e) {
+  const int n = f.size () - 1;
+  const std::vector<int> order = big_topological_order (f, e);
+  std::vector<int> position (n);
+  for (int i = 0; i < n; i++)
+    position[order[i]] = i;
+
+  std::vector<int> owner (n, -1), edge (n);
+  std::vector<char> redundant (e.size ());
+  const size_t limit = 10 * e.size () + 1000;
+  size_t steps = 0;
+  for (int u = 0; u < n && steps < limit; u++) {
+    if (f[u + 1] - f[u] < 2)
+      continue;
+    for (int k = f[u]; k < f[u + 1]; k++)
+      owner[e[k]] = u, edge[e[k]] = k;
+    for (int k = f[u]; k < f[u + 1]; k++) {
+      const int v = e[k];
+      for (int l = f[v]; l < f[v + 1]; l++) {
+        const int w = e[l];
+        steps++;
+        if (owner[w] == u)
+          redundant[edge[w]] = true;
+      }
+    }
+  }
+
+  for (int u = 0; u < n; u++)
+    for (int k = f[u]; k < f[u + 1]; k++) {
+      if (!redundant[k])
+        continue;
+      const int v = neg (e[k]);
+      for (int l = f[v]; l < f[v + 1]; l++)
+        if (e[l] == neg (u))
+          redundant[l] = true;
+    }
+
+  size_t j = 0;
+  std::vector<int> f_prime (n + 1);
+  for (int u = 0; u < n; u++) {
+    f_prime[u] = j;
+    for (int k = f[u]; k < f[u + 1]; k++)
+      if (!redundant[k])
+        e[j++] = e[k];
+    std::sort (e.begin () + f_prime[u], e.begin () + j,
+               [&] (int a, int b) { return position[a] < position[b]; });
+  }
+  f_prime[n] = j;
+  msg ("BIG reduced %zu of %zu edges (%.0f%%) in %zu steps",
+       e.size () - j, e.size (), percent (e.size () - j, e.size ()),
+       steps);
+  e.resize (j);
+  f = std::move (f_prime);
+}
+
+// Bit-parallel version of KB3 used with '--big-lanes' on the acyclic BIG
+// after ELS.  Each job probes 64 literals
+// at once, one per bit (lane) of a reachability mask for each node, which
+// is propagated along the nodes reachable from the probes in topological
+// order.  If a node and its negation are reached in the same lane the probe
+// of that lane fails and its negation is a backbone.  Nodes reached by a
+// probe which does not fail can not fail either and are not probed anymore.
+// Probes are picked in topological order to make this pruning effective.
+
+static void big_backbone_lanes (const std::vector<int> &f,
+                                const std::vector<int> &e) {
+  msg ("BIG probing 64 lanes for backbones after %.2f seconds", time ());
+  const int n = f.size () - 1;
+  const std::vector<int> order = big_topological_order (f, e);
+  std::vector<int> position (n);
+  for (int i = 0; i < n; i++)
+    position[order[i]] = i;
+
+  const int jobs = big_jobs (e.size ());
+  const size_t lanes = 64;
+  std::vector<std::vector<uint64_t>> masks (jobs);
+  std::vector<std::vector<char>> seen (jobs);
+  std::vector<std::vector<int>> reached (jobs);
+  std::vector<uint64_t> failed (jobs);
+  std::vector<char> safe (n);
+  std::vector<int> probes;
+  size_t next = 0, rounds = 0;
+
+  for (;;) {
+    probes.clear ();
+    while (next < order.size () && probes.size () < lanes * jobs) {
+      const int c = order[next++];
+      if (!safe[c] && !fixed_literal (var (c)) && f[c] < f[c + 1])
+        probes.push_back (c);
+    }
+    if (probes.empty ())
+      break;
+    rounds++;
+
+    run_jobs (jobs, [&] (int j) {
+      const size_t begin = lanes * j;
+      const size_t end = std::min (probes.size (), begin + lanes);
+      failed[j] = 0;
+      reached[j].clear ();
+      if (begin >= end)
+        return;
+      std::vector<uint64_t> &mask = masks[j];
+      std::vector<char> &visited = seen[j];
+      mask.resize (n);
+      visited.resize (n);
+      std::vector<int> region;
+      for (size_t l = begin; l != end; l++) {
+        const int c = probes[l];
+        mask[c] |= (uint64_t) 1 << (l - begin);
+        visited[c] = true;
+        region.push_back (c);
+      }
+      for (size_t i = 0; i < region.size (); i++) {
+        const int u = region[i];
+        for (int k = f[u]; k < f[u + 1]; k++) {
+          const int v = e[k];
+          if (visited[v])
+            continue;
+          visited[v] = true;
+          region.push_back (v);
+        }
+      }
+      std::sort (region.begin (), region.end (), [&] (int a, int b) {
+        return position[a] < position[b];
+      });
+      for (int u : region)
+        for (int k = f[u]; k < f[u + 1]; k++)
+          mask[e[k]] |= mask[u];
+      uint64_t conflicts = 0;
+      for (int u : region)
+        conflicts |= mask[u] & mask[neg (u)];
+      for (int u : region) {
+        if (mask[u] & ~conflicts)
+          reached[j].push_back (u);
+        mask[u] = 0;
+        visited[u] = false;
+      }
+      failed[j] = conflicts;
+    });
+
+    for (int j = 0; j != jobs; j++) {
+      for (int u : reached[j])
+        safe[u] = true;
+      for (uint64_t conflicts = failed[j]; conflicts;
+           conflicts &= conflicts - 1) {
+        const int c = probes[lanes * j + __builtin_ctzll (conflicts)];
+        if (!fixed_literal (var (c)))
+          big_backbone_node (neg (c));
+      }
+    }
+  }
+  msg ("BIG probed in %zu rounds of %d jobs", rounds, jobs);
+}
+
+// The multiplicative controller of '--adaptive' (see above) called after
+// each solver call in 'iterate' with the number of candidates constrained
+// or assumed in that call and the number of candidates it determined.
+
+static const double adaptive_smoothing = 0.1; // Weight of the last call.
+static const double adaptive_slow = 2.0;      // Factor of average time.
+
+static void adapt_constraint_limit (Worker *worker, int &limit, int size,
+                                    int res, size_t determined) {
+  const double time = worker->time;
+  const double average = worker->sat_time;
+  if (res) {
+    double &smoothed = (res == 10) ? worker->sat_time : worker->unsat_time;
+    smoothed = smoothed ? smoothed + adaptive_smoothing * (time - smoothed)
+                        : time;
+  }
+  auto &statistics = worker->statistics.adaptive;
+  if ((size_t) size > statistics.max_limit)
+    statistics.max_limit = size;
+  if (res == 20) {
+    if (size < limit || limit > INT_MAX / 2)
+      return;
+    if (average && time > adaptive_slow * average)
+      return;
+    limit *= 2;
+    statistics.increased++;
+    dbg ("increased constraint limit to %d", limit);
+  } else {
+    assert (res == 10 || !res); // Also decreased if out of '--budget'.
+    if (res && 2 * determined >= (size_t) size &&
+        (!average || time <= adaptive_slow * average))
+      return;
+    const int new_limit = std::max (1, std::min (limit, size) / 2);
+    if (new_limit == limit)
+      return;
+    limit = new_limit;
+    statistics.decreased++;
+    dbg ("decreased constraint limit to %d", limit);
+  }
+}
+
+// For cores a satisfiable call is the successful case as it drops all
+// the assumed candidates at once.
+
+static void adapt_core_limit (Worker *worker, int &limit, int size,
+                              bool satisfied) {
+  auto &statistics = worker->statistics.adaptive;
+  if ((size_t) size > statistics.max_core_limit)
+    statistics.max_core_limit = size;
+  if (satisfied) {
+    if (size < limit || limit > INT_MAX / 2)
+      return;
+    limit *= 2;
+    statistics.core_increased++;
+    dbg ("increased core limit to %d", limit);
+  } else if (limit > 2) {
+    limit = std::max (2, limit / 2);
+    statistics.core_decreased++;
+    dbg ("decreased core limit to %d", limit);
+  }
+}
+
+// Now go over all variables in the slice of the worker in turn and check
+// whether they still are candidates for being a backbone variables.  Each
+// step of this loop either drops at least one candidate or determines at
+// least one candidate to be a backbone (or skips already dropped
+// variables).
+
+static void limit_conflicts (Worker *worker) {
+  if (worker->budget)
+    worker->solver->limit ("conflicts", worker->budget);
+}
+
+// The constraint and core stacks of a worker only grow to the largest size
+// actually needed instead of being allocated for its whole slice.
+
+static void push_literal (std::vector<int> &stack, int &size, int lit) {
+  assert ((size_t) size <= stack.size ());
+  if ((size_t) size == stack.size ())
+    stack.push_back (lit);
+  else
+    stack[size] = lit;
+  size++;
+}
+
+static void iterate (Worker *worker) {
+
+  CaDiCaL::Solver *solver = worker->solver;
+  std::vector<int> &constraint = worker->constraint;
+  std::vector<int> &core = worker->core;
+
+  int activation_variable = solver->vars (); // If '--no-contrain'.
+  int constraint_limit = INT_MAX; // Adapted dynamically using 'last'.
+  int core_limit = initial_core_limit;
+  int last = 10; // Last solver result.
+
+  if (adaptive && initial_constraint_limit)
+    constraint_limit = initial_constraint_limit;
+
+  // Positions of candidates deferred with '--budget'.  After all positions
+  // of the slice these are retried in rounds, i.e., up to 'round', with the
+  // budget doubled for each round.
+
+  std::vector<int> deferred;
+  size_t retried = 0, round = 0;
+  int next = worker->begin;
+  worker->budget = budget;
+
+  for (;;) {
+
+    int pos;
+    if (next <= worker->end)
+      pos = next++;
+    else if (retried != deferred.size ()) {
+      if (retried == round) {
+        round = deferred.size ();
+        if (worker->budget < INT_MAX / 2)
+          worker->budget *= 2;
+        msg ("retrying %zu deferred candidates with budget %d",
+             round - retried, worker->budget);
+      }
+      pos = deferred[retried++];
+    } else
+      break;
+
+    const int idx = permuted (pos);
+
+    // First skip variables that have been dropped as candidates
+    // before.
+
+    int lit = candidate (idx);
+    if (!lit)
+      continue;
+
+    // With 'constrain' we might drop another literal but not 'idx'
+    // and in that case simply restart checking 'idx' for being a
+    // candidate (same applies if 'cores' are enabled).
+
+  TRY_SAME_CANDIDATE_AGAIN:
+
+    assert (threads > 1 || lit == candidate (idx));
+    assert (lit);
+
+    import_units (worker);
+
+    // If not disabled by '--no-fixed' filter root-level fixed
+    // literals.
+
+    if (!no_fixed && fix_candidate (worker, idx))
+      continue;
+
+    if (cache && drop_cached_candidate (worker, idx))
+      continue;
+
+    if (cores) {
+
+      assert (core_limit > 1);
+      int assumed = 0;
+
+      assert (assumed <= worker->end - worker->begin);
+      push_literal (core, assumed, -lit);
+
+      for (int next = pos + 1; next <= worker->end; next++) {
+        const int other = permuted (next);
+        int lit_other = candidate (other);
+        if (!lit_other)
+          continue;
+        if (!no_fixed && fix_candidate (worker, other))
+          continue;
+        assert (assumed <= worker->end - worker->begin);
+        push_literal (core, assumed, -lit_other);
+
+        if (assumed == core_limit)
+          break;
+      }
+
+      bool progress = false;
+      const int core_size = assumed;
+      bool core_satisfied = false;
+
+      while (assumed) {
+
+        dbg ("core based approach assumes %d literals", assumed);
+
+        for (int i = 0; i != assumed; i++)
+          solver->assume (core[i]);
+
+        limit_conflicts (worker);
+        int tmp = solve (worker, "core", assumed);
+        if (!tmp) {
+          dbg ("core based approach out of budget");
+          break;
+        }
+        if (tmp == 10) {
+
+          dbg ("all %d negatively assumed backbone candidates "
+               "can be dropped",
+               assumed);
+
+          for (int i = 0; i != assumed; i++)
+            if (drop_candidate (worker, abs (core[i])))
+              worker->statistics.failed++;
+
+          assert (INT_MAX - assumed >= idx);
+          filter_candidates (worker, remaining (worker, pos));
+          progress = true;
+          core_satisfied = (assumed == core_size);
+          assumed = -1;
+          break;
+        }
+
+        assert (tmp == 20);
+
+        int num_failed = 0;
+        int failed_lit = 0;
+        int remain = 0;
+
+        for (int i = 0; i != assumed; i++) {
+          int other = core[i];
+          bool other_failed = solver->failed (other);
+          if (other_failed) {
+            failed_lit = other;
+            num_failed++;
+          }
+          int other_idx = abs (other);
+          int other_lit = candidate (other_idx);
+          if (!other_lit) {
+            // Dropped by other worker or with an equivalent variable.
+            assert (threads > 1 || !equivalences.empty ());
+            continue;
+          }
+          assert (other_lit == -other);
+          if (!no_fixed && fix_candidate (worker, other_idx)) {
+            progress = true;
+            continue;
+          }
+          if (!other_failed)
+            core[remain++] = other;
+        }
+
+        dbg ("failed literal core of size %d", num_failed);
+        assert (remain < assumed);
+        assert (num_failed);
+
+        if (num_failed == 1 &&
+            backbone_variable (worker, abs (failed_lit))) {
+          worker->statistics.failed++;
+          progress = true;
+        }
+
+        assumed = remain;
+        dbg ("reducing core assumptions to complement of size %d",
+             remain);
+      }
+
+      if (adaptive)
+        adapt_core_limit (worker, core_limit, core_size, core_satisfied);
+
+      if (progress) {
+
+        dbg ("continuing with next core");
+
+        if (candidate (idx))
+          goto TRY_SAME_CANDIDATE_AGAIN;
+        else
+          continue;
+      }
+
+      dbg ("falling back to iterative approach");
+    }
+
+    // If not disabled through '--one-by-one' use the 'constrain'
+    // optimization which assumes the disjunction of the negation of all
+    // remaining possible backbone candidate literals.  By default this
+    // uses the 'constrain' API call described in our FMCAD'21 paper
+    // (unless '--no-constrain' is specified in which case we use
+    // activation literals as in 'MiniBones')).
+
+    // If the remaining backbone candidates are all actually backbones
+    // then only one such call can be enough to prove it. Otherwise
+    // without 'constraints' we need as many solver calls as there are
+    // candidates.  Without constrain this puts heavy load on the
+    // 'restore' algorithm which in some instances ended up taking 99%
+    // of the running time.
+
+    // It seems reasonable to limit the size of the constraint (the
+    // number of negated candidate literals where one is assumed to be
+    // flippable) by some sort of chunking.  In contrast to earlier work
+    // in 'MiniBones' we adapt the limit during chunking as follows.  As
+    // long constraint was unsatisfiable (and all the contained
+    // candidates are thus fixed) we increase the limit on the
+    // considered candidates in the constraint exponentially (by the
+    // hard coded factor 10).  If the call returns a model we go back to
+    // checking candidates one-by-one.  If the following call returns
+    // unsatisfiable, we limit the size of the constraint to 10
+    // candidates next time etc.
+
+    if (!one_by_one && chunking) {
+      if (last == 20)
+        constraint_limit = (constraint_limit < INT_MAX / 10)
+                               ? 10 * constraint_limit
+                               : INT_MAX;
+      else
+        constraint_limit = 1;
+    }
+
+    if (!one_by_one && (adaptive ? constraint_limit > 1 : last == 20)) {
+
+      assert (constraint_limit > 1);
+      int assumed = 0;
+      assert (assumed <= worker->end - worker->begin);
+      push_literal (constraint, assumed, -lit);
+
+      for (int next = pos + 1; next <= worker->end; next++) {
+        const int other = permuted (next);
+        int lit_other = candidate (other);
+        if (!lit_other)
+          continue;
+        if (!no_fixed && fix_candidate (worker, other))
+          continue;
+        if (cache && drop_cached_candidate (worker, other))
+          continue;
+        assert (assumed <= worker->end - worker->begin);
+        push_literal (constraint, assumed, -lit_other);
+
+        if (assumed == constraint_limit)
+          break;
+      }
+
+      if (assumed == 1)
+        goto ASSUME_NEGATION_OF_SINGLE_BACKBONE_CANDIDATE;
+
+      dbg ("assuming negation of %d remaining backbone "
+           "candidates starting with variable %d",
+           assumed, idx);
+
+      if (no_constrain) {
+        activation_variable++;
+        dbg ("new activation variable %s", activation_variable);
+        solver->add (activation_variable);
+        for (int i = 0; i != assumed; i++)
+          solver->add (constraint[i]);
+        solver->add (0);
+        solver->assume (-activation_variable);
+      } else {
+        for (int i = 0; i != assumed; i++)
+          solver->constrain (constraint[i]);
+        solver->constrain (0);
+      }
+
+      const size_t before = worker->statistics.dropped;
+      limit_conflicts (worker);
+      last = solve (worker, "constrained", assumed);
+      if (last == 10) {
+        dbg ("constraining negation of %d backbones candidates "
+             "starting with variable %d all-at-once produced model",
+             assumed, idx);
+        int other = drop_first_candidate (worker, pos);
+        filter_candidates (worker,
+                           remaining (worker, other ? other + 1 : pos));
+        try_to_flip_remaining (worker, remaining (worker, pos));
+      }
+
+      if (adaptive)
+        adapt_constraint_limit (worker, constraint_limit, assumed, last,
+                                last == 20
+                                    ? (size_t) assumed
+                                    : worker->statistics.dropped - before);
+
+      if (no_constrain) {
+        solver->add (activation_variable);
+        solver->add (0);
+        worker->satisfied = false;
+      }
+
+      if (last == 10) {
+
+        diversify_models (worker);
+
+        lit = candidate (idx);
+        if (lit)
+          goto TRY_SAME_CANDIDATE_AGAIN;
+
+        continue; // ... with next candidate.
+      }
+
+      if (!last) {
+        dbg ("constraint out of budget");
+        goto ASSUME_NEGATION_OF_SINGLE_BACKBONE_CANDIDATE;
+      }
+
+      assert (last == 20);
+      msg ("%d remaining candidates starting at %d "
+           "shown to be backbones in one call",
+           assumed, lit);
+      backbone_variables (worker, assumed); // Plural!  So all assumed.
+      continue;
+    }
+
+  ASSUME_NEGATION_OF_SINGLE_BACKBONE_CANDIDATE:
+
+    dbg ("no other literal besides %d remains a backbone candidate",
+         lit);
+
+    dbg ("assuming negation %d of backbone candidate %d", -lit, lit);
+    solver->assume (-lit);
+    limit_conflicts (worker);
+    last = solve (worker, "single", 1);
+    if (adaptive)
+      adapt_constraint_limit (worker, constraint_limit, 1, last, 1);
+    if (last == 10) {
+      dbg ("found model satisfying single assumed "
+           "negation %d of backbone candidate %d",
+           -lit, lit);
+      drop_candidate (worker, idx); // Unless dropped by other worker.
+      filter_candidates (worker, remaining (worker, pos + 1));
+      assert (!candidate (idx));
+      try_to_flip_remaining (worker, remaining (worker, pos + 1));
+      diversify_models (worker);
+    } else if (last == 20) {
+      dbg ("no model with %d thus found backbone literal %d", -lit,
+           lit);
+      backbone_variable (worker, idx); // Singular! So only this one.
+    } else {
+      assert (!last);
+      dbg ("deferring backbone candidate %d out of budget", lit);
+      deferred.push_back (pos);
+      worker->statistics.deferred++;
+    }
+  }
+
+}
+
+// Count the occurrences of variables in all (or only binary) clauses for
+// sorting the slices with '--order'.
+
+class OccurrenceCounter : public CaDiCaL::ClauseIterator {
+public:
+  std::vector<unsigned> &count;
+  const bool binary;
+  OccurrenceCounter (std::vector<unsigned> &count, bool binary)
+      : count (count), binary (binary) {}
+  bool clause (const std::vector<int> &c) {
+    if (binary && c.size () != 2)
+      return true;
+    for (auto lit : c)
+      count[abs (lit)]++;
+    return true;
+  }
+};
+
+// Sort the variables of each slice by decreasing number of occurrences.
+// As this is a stable sort ties are broken by the variable index.
+
+static void permute_slices () {
+  std::vector<unsigned> count (vars + 1);
+  OccurrenceCounter counter (count, !strcmp (order, "binary"));
+  solver->traverse_clauses (counter);
+  permutation = new int[vars + 1];
+  if (!permutation)
+    fatal ("out-of-memory allocating candidate permutation");
+  std::iota (permutation, permutation + vars + 1, 0);
+  for (int i = 0; i != threads; i++) {
+    Worker *worker = workers + i;
+    std::stable_sort (permutation + worker->begin,
+                      permutation + worker->end + 1,
+                      [&] (int a, int b) { return count[a] > count[b]; });
+  }
+}
+
+// Split the candidate variables into consecutive slices, one for each
+// worker, and copy the main solver for all but the first worker.  This
+// has to happen after the candidates are initialized by the first model.
+
+static void configure_solver (CaDiCaL::Solver *);
+
+static void init_workers () {
+  const int size_of_range = range.end - range.begin + 1;
+  for (int i = 0; i != threads; i++) {
+    Worker *worker = workers + i;
+    worker->id = i;
+    worker->begin = range.begin + (long long) size_of_range * i / threads;
+    worker->end = range.begin - 1 +
+                  (long long) size_of_range * (i + 1) / threads;
+    assert (worker->end - worker->begin + 1 >= 0);
+    if (!i) {
+      assert (worker->solver == solver);
+      continue;
+    }
+    dbg ("copying solver of worker %d for variables %d to %d", i,
+         worker->begin, worker->end);
+    worker->solver = new CaDiCaL::Solver ();
+    configure_solver (worker->solver);
+    solver->copy (*worker->solver);
+    if (set_phase)
+      for (int idx = 1; idx <= vars; idx++)
+        if (candidate (idx))
+          worker->solver->phase (-candidate (idx));
+  }
+  if (order)
+    permute_slices ();
+}
+
+// The main thread runs the first worker while the other workers run in
+// their own thread (only with '--threads').
+
+static void run_workers () {
+  if (threads == 1) {
+    iterate (workers);
+    return;
+  }
+  msg ("starting %d worker threads after %.2f seconds", threads, time ());
+  std::vector<std::thread> running;
+  parallel = true;
+  for (int i = 1; i != threads; i++)
+    running.push_back (std::thread (iterate, workers + i));
+  iterate (workers);
+  for (auto &thread : running)
+    thread.join ();
+  parallel = false;
+  msg ("all %d worker threads finished after %.2f seconds", threads,
+       time ());
+}
+
+static void release_workers () {
+  for (int i = 0; i != threads; i++) {
+    Worker *worker = workers + i;
+    if (trace)
+      finish_trace_event (worker);
+    std::vector<int> ().swap (worker->constraint);
+    std::vector<int> ().swap (worker->core);
+    if (i)
+      delete worker->solver;
+  }
+  delete[] permutation;
+  permutation = 0;
+}
+
+static void configure_solver (CaDiCaL::Solver *solver) {
+  if (no_inprocessing)
+    solver->set ("inprocessing", 0);
+
+  if (verbosity < 0)
+    solver->set ("quiet", 1);
+  else if (verbosity > 1)
+    solver->set ("verbose", verbosity - 2);
+  if (report || verbosity > 1)
+    solver->set ("report", 1);
+}
+
+// The value of a literal in a witness model with the variable 'flipped'
+// flipped.  Variables added after recording the model are unknown and
+// considered to be false, which is safe for 'satisfies' below.
+
+static bool witness_value (const WitnessModel &model, int flipped,
+                           int lit) {
+  const int idx = abs (lit);
+  if (idx > model.vars)
+    return false;
+  bool value = model.bits[idx >> 6] & candidate_bit (idx);
+  if (idx == flipped)
+    value = !value;
+  return lit < 0 ? !value : value;
+}
+
+// Check that the witness model satisfies the zero terminated 'clauses' (or
+// without 'terminated' all literals as unit clauses).
+
+static bool satisfies (const WitnessModel &model, int flipped,
+                       const std::vector<int> &clauses, bool terminated) {
+  bool satisfied = false;
+  for (auto lit : clauses) {
+    if (!terminated) {
+      if (!witness_value (model, flipped, lit))
+        return false;
+    } else if (!lit) {
+      if (!satisfied)
+        return false;
+      satisfied = false;
+    } else if (!satisfied && witness_value (model, flipped, lit))
+      satisfied = true;
+  }
+  return true;
+}
+
+// Determine candidates by the backbones and the still valid witness models
+// of the previous incremental query after the first model was found.  The
+// models can grow while dropping candidates, thus we need to index them.
+
+static void reuse_previous_query (Worker *worker) {
+
+  if (!witnesses)
+    return;
+
+  for (auto lit : reused_backbones) {
+    const int idx = abs (lit);
+    if (idx > vars || !candidate (idx))
+      continue;
+    assert (candidate (idx) == lit);
+    if (backbone_variable (worker, idx))
+      worker->statistics.reused++;
+  }
+
+  const size_t size = witnesses->models.size ();
+  for (size_t i = 0; i != size; i++) {
+    if (!satisfies (witnesses->models[i], 0, assumptions, false))
+      continue;
+    const int model_vars = witnesses->models[i].vars;
+    for (int word = 0; word <= model_vars >> 6; word++) {
+      uint64_t mask = candidate_word (word);
+      if (word == model_vars >> 6)
+        mask &= ((uint64_t) 2 << (model_vars & 63)) - 1;
+      uint64_t refuted =
+          mask & (witnesses->models[i].bits[word] ^ positive[word]);
+      while (refuted) {
+        const int idx = 64 * word + __builtin_ctzll (refuted);
+        refuted &= refuted - 1;
+        if (drop_candidate (worker, idx))
+          worker->statistics.reused++;
+      }
+    }
+  }
+
+  const size_t flipped = witnesses->flipped.size ();
+  for (size_t i = 0; i != flipped; i++) {
+    const auto pair = witnesses->flipped[i];
+    const int idx = pair.second;
+    const int lit = candidate (idx);
+    if (!lit)
+      continue;
+    const WitnessModel &model = witnesses->models[pair.first];
+    if (witness_value (model, idx, lit) ||
+        !satisfies (model, idx, assumptions, false))
+      continue;
+    if (drop_candidate (worker, idx))
+      worker->statistics.reused++;
+  }
+}
+
+// Determine the backbones and drop the candidates read by '--resume'.  The
+// first model satisfies the resumed backbones as they were assumed, which
+// are now added as units to the solver (but not to the already copied
+// checker) as later calls do not assume them anymore.
+
+static void resume_previous_run (Worker *worker) {
+  for (auto lit : resumed_backbones) {
+    solver->add (lit);
+    solver->add (0);
+    const int idx = abs (lit);
+    if (!candidate (idx))
+      continue;
+    assert (candidate (idx) == lit);
+    if (backbone_variable (worker, idx))
+      worker->statistics.resumed++;
+  }
+  for (auto idx : resumed_dropped)
+    if (drop_candidate (worker, idx))
+      worker->statistics.resumed++;
+}
+
+// The claims are split into shards which the jobs take from a work queue,
+// each job with its own copy of the checker.  A shard of claimed backbones
+// needs only one call, constraining the checker by the disjunction of
+// their negations, which has to be unsatisfiable.  Otherwise the model
+// shows which backbone is wrong.  For a shard of claimed models we assume
+// one remaining claim after the other and each model found also checks
+// all other remaining claims of the shard which it satisfies.
+
+static bool satisfied (CaDiCaL::Solver *solver, int lit) {
+  const int idx = abs (lit);
+  return (solver->val (idx) < 0 ? -idx : idx) == lit; // Legacy support.
+}
+
+static void verify_claims (CaDiCaL::Solver *base) {
+  const size_t num_backbones = claimed_backbones.size ();
+  const size_t num_models = claimed_models.size ();
+  const size_t total = num_backbones + num_models;
+  if (!total)
+    return;
+  const int jobs = std::max (1, checkers);
+  const size_t shards_per_job = 4;
+  const size_t shard_size =
+      std::max ((size_t) 1, total / (jobs * shards_per_job));
+  const size_t backbone_shards =
+      (num_backbones + shard_size - 1) / shard_size;
+  const size_t model_shards = (num_models + shard_size - 1) / shard_size;
+  msg ("checking %zu claimed backbones and %zu models in %zu shards "
+       "with %d checkers",
+       num_backbones, num_models, backbone_shards + model_shards, jobs);
+  std::vector<CaDiCaL::Solver *> copies (jobs, base);
+  for (int j = 1; j < jobs; j++) {
+    copies[j] = new CaDiCaL::Solver ();
+    configure_solver (copies[j]);
+    base->copy (*copies[j]);
+  }
+  std::atomic<size_t> next (0);
+  run_jobs (jobs, [&] (int j) {
+    CaDiCaL::Solver *solver = copies[j];
+    std::vector<int> remain;
+    for (;;) {
+      size_t shard = next++;
+      if (shard < backbone_shards) {
+        const size_t begin = shard * shard_size;
+        const size_t end = std::min (begin + shard_size, num_backbones);
+        for (size_t i = begin; i != end; i++)
+          solver->constrain (-claimed_backbones[i]);
+        solver->constrain (0);
+        assume_assumptions (solver);
+        const TraceClock clock = trace_clock ();
+        const int res = solver->solve ();
+        if (trace)
+          trace_event (-1 - j, "check", end - begin, res, clock);
+        if (res == 20)
+          continue;
+        for (size_t i = begin; i != end; i++)
+          if (!satisfied (solver, claimed_backbones[i]))
+            fatal ("checking %d backbone failed", claimed_backbones[i]);
+        fatal ("checking backbones failed");
+      }
+      shard -= backbone_shards;
+      if (shard >= model_shards)
+        break;
+      const size_t begin = shard * shard_size;
+      const size_t end = std::min (begin + shard_size, num_models);
+      remain.assign (claimed_models.begin () + begin,
+                     claimed_models.begin () + end);
+      while (!remain.empty ()) {
+        const int lit = remain.back ();
+        assume_assumptions (solver);
+        solver->assume (lit);
+        const TraceClock clock = trace_clock ();
+        const int res = solver->solve ();
+        if (trace)
+          trace_event (-1 - j, "check", 1, res, clock);
+        if (res != 10)
+          fatal ("checking claimed model for %d failed", lit);
+        size_t kept = 0;
+        for (auto other : remain)
+          if (!satisfied (solver, other))
+            remain[kept++] = other;
+        assert (kept < remain.size ());
+        remain.resize (kept);
+      }
+    }
+  });
+  for (int j = 1; j < jobs; j++)
+    delete copies[j];
+  claimed_backbones.clear ();
+  claimed_models.clear ();
+}
+
+// Find the first pair of options which do not make sense together.
+
+static bool incompatible_options (const char *&a, const char *&b) {
+  a = b = 0;
+  if (one_by_one && chunking)
+    a = chunking, b = one_by_one;
+  else if (one_by_one && adaptive)
+    a = adaptive, b = one_by_one;
+  else if (chunking && adaptive)
+    a = adaptive, b = chunking;
+  else if (one_by_one && no_constrain)
+    a = no_constrain, b = one_by_one;
+#ifndef NFLIP
+  else if (no_flip && really_flip)
+    a = really_flip, b = no_flip;
+  else if (no_flip && bulk_flip)
+    a = bulk_flip, b = no_flip;
+#endif
+  else if (big_no_els && big_roots)
+    a = big_no_els, b = big_roots;
+  else if (big_no_els && big_lanes)
+    a = big_no_els, b = big_lanes;
+  else if (big_no_els && big_reduce)
+    a = big_no_els, b = big_reduce;
+  else if (big_roots && big_lanes)
+    a = big_roots, b = big_lanes;
+  return a;
+}
+
+static void release_checker () {
+  delete checker;
+  checker = 0;
+}
+
+// Link the variables of each equivalence class of ELS (with a positive
+// representative, the first node of its group in 'extension') to a ring.
+// Classes of BIG backbones are skipped as they are already determined.
+
+static void init_equivalences (const std::vector<int> &extension) {
+  size_t classes = 0, linked = 0;
+  for (size_t i = 0; i < extension.size (); i++) {
+    const int first = extension[i];
+    size_t end = i;
+    while (extension[end] != -1)
+      end++;
+    if (lit (first) > 0 && !fixed_literal (var (first))) {
+      if (equivalences.empty ())
+        equivalences.resize (vars + 1);
+      for (size_t j = i; j + 1 < end; j++)
+        equivalences[var (extension[j])] = var (extension[j + 1]);
+      equivalences[var (extension[end - 1])] = var (first);
+      linked += end - i;
+      classes++;
+    }
+    i = end;
+  }
+  if (classes)
+    msg ("linked %zu equivalent variables in %zu classes", linked,
+         classes);
+}
+
+// The actual backbone extraction for the formula in 'solver' with 'vars'
+// variables shared by the stand-alone tool and the library.  Returns '10'
+// if the formula is satisfiable and all backbones have been reported and
+// '20' if it is unsatisfiable.  The workers are kept for printing
+// statistics and have to be deleted by the caller.
+
+static int extract () {
+
+  int res = 0;
+
+  if (check)
+    checker = new CaDiCaL::Solver ();
+
+  range.begin = 1 + (long long) vars * (slice - 1) / slices;
+  range.end = (long long) vars * slice / slices;
+  if (slices > 1)
+    msg ("slice %d of %d ranges from variable %d to %d", slice, slices,
+         range.begin, range.end);
+
+  const int size_of_range = range.end - range.begin + 1;
+  if (threads > 1 && threads > size_of_range) {
+    threads = size_of_range > 0 ? size_of_range : 1;
+    msg ("reducing number of worker threads to %d", threads);
+  }
+
+  workers = new Worker[threads] ();
+  if (!workers)
+    fatal ("out-of-memory allocating workers");
+  workers[0].solver = solver;
+
+  if (big) {
+    msg ("starting BIG search after %.2f seconds", time ());
+    std::vector<int> f, e;
+    const int num_nodes = 2 * vars;
+    start_timer (&big_read_time);
+    big_extract (num_nodes, f, e);
+    stop_timer ();
+
+    // Keeps track of the ELS groups.
+    // If the representative of a group of literals is found to be a
+    // backbone all literals in the group need to be marked as a backbone.
+    std::vector<int> extension;
+    start_timer (&big_els_time);
+    if (!big_no_els)
+      res = big_els (f, e, extension);
+    stop_timer ();
+
+    if (res) {
+      assert (res == 20);
+      msg ("Unsatisfiability determined by ELS");
+      if (check)
+        assert (solve (workers, "first", 0) == 20);
+      release_checker ();
+      return res;
+    }
+
+    // Allocated only after ELS to keep the peak memory usage down.
+
+    init_fixed ();
+    marked = new char[num_nodes];
+    if (!marked)
+      fatal ("out-of-memory allocating marked flag for BIG nodes");
+    for (int u = 0; u < num_nodes; u++)
+      marked[u] = false;
+
+    if (big_reduce) {
+      start_timer (&big_reduce_time);
+      big_reduce_transitive (f, e);
+      stop_timer ();
+    }
+
+    start_timer (&big_search_time);
+    if (big_roots)
+      big_backbone<true> (f, e);
+    else if (big_lanes)
+      big_backbone_lanes (f, e);
+    else
+      big_backbone<false> (f, e);
+    stop_timer ();
+    if (check) {
+      start_timer (&big_check_time);
+      std::vector<int> backbone, backbone_base, dummy;
+      if (!big_no_els || !big_els (f, e, dummy, true)) {
+        for (int idx = 1; idx <= vars; idx++)
+          if (fixed_literal (idx))
+            backbone.push_back (fixed_literal (idx));
+        clear_fixed ();
+        for (size_t u = 0; u < f.size () - 1; u++)
+          marked[u] = false;
+        workers->statistics.backbones = 0;
+        workers->statistics.big_backbones = 0;
+        const size_t reached = backbones_reached;
+        backbones_reached = 0;
+        determined = 0;
+        big_backbone_base (f, e);
+        assert (backbones_reached == reached);
+        (void) reached;
+        for (int idx = 1; idx <= vars; idx++)
+          if (fixed_literal (idx))
+            backbone_base.push_back (fixed_literal (idx));
+        assert (backbone == backbone_base);
+      }
+      stop_timer ();
+    }
+
+    // The extension only needs the backbones.
+
+    delete[] marked;
+    marked = 0;
+    std::vector<int> ().swap (f);
+    std::vector<int> ().swap (e);
+
+    // extending backbones to their scc
+    start_timer (&big_extension_time);
+    int fixed_val = 0;
+    for (int u : extension) {
+      if (u == -1)
+        fixed_val = 0;
+      else if (fixed_val)
+        big_backbone_node (u);
+      else {
+        const int val = fixed_literal (var (u));
+        if (val == lit (u))
+          fixed_val = val;
+      }
+    }
+    stop_timer ();
+
+    msg ("BIG found %zu backbones after %.2f seconds",
+         workers->statistics.big_backbones, time ());
+    init_equivalences (extension);
+  } else if (els) {
+    msg ("starting ELS after %.2f seconds", time ());
+    std::vector<int> f, e, extension;
+    start_timer (&big_read_time);
+    big_extract (2 * vars, f, e);
+    stop_timer ();
+    start_timer (&big_els_time);
+    res = big_els (f, e, extension);
+    stop_timer ();
+    if (res) {
+      assert (res == 20);
+      msg ("Unsatisfiability determined by ELS");
+      if (check)
+        assert (solve (workers, "first", 0) == 20);
+      release_checker ();
+      return res;
+    }
+    std::vector<int> ().swap (f);
+    std::vector<int> ().swap (e);
+    init_fixed ();
+    init_equivalences (extension);
+  }
+
+  // Determine first model or that formula is unsatisfiable.
+
+  line ();
+  msg ("starting solving after %.2f seconds", time ());
+  for (auto lit : resumed_backbones)
+    solver->assume (lit);
+  res = solve (workers, "first", resumed_backbones.size ());
+  assert (res == 10 || res == 20);
+  if (res == 20 && !resumed_backbones.empty () &&
+      solve (workers, "first", 0) == 10)
+    fatal ("resumed backbones inconsistent with formula");
+
+  if (checker) {
+    dbg ("copying checker after first model");
+    solver->copy (*checker);
+  }
+
+  if (res == 10) {
+
+    msg ("solver determined first model after %.2f seconds", time ());
+    if (report || verbosity > 1)
+      line ();
+
+    init_candidates ();
+
+    if (!fixed)
+      init_fixed ();
+
+    // Initialize the candidate backbone literals with first model.
+
+    unprojected = 0;
+    for (int idx = 1; idx <= vars; idx++) {
+      int lit = solver->val (idx) < 0 ? -idx : idx; // Legacy support.
+      assert (lit == idx || lit == -idx);
+      if (fixed_literal (idx))
+        ;
+      else if (projected.empty () ||
+               ((size_t) idx < projected.size () && projected[idx]))
+        add_candidate (lit);
+      else
+        unprojected++;
+      // If enabled by '--set-phase' set opposite value as default
+      // decision phase.  This seems to have  negative effects with and
+      // without using 'constrain' and thus is disabled by default.
+
+      if (set_phase)
+        solver->phase (-lit);
+    }
+
+    reuse_previous_query (workers);
+    resume_previous_run (workers);
+
+    // Use first model to flip as many literals as possible which if
+    // successful is cheaper than calling the SAT solver.
+
+    try_to_flip_remaining (workers, 1);
+
+    // Then failed literal probing of the remaining candidates.
+
+    probe_candidates (workers);
+
+    init_workers ();
+    run_workers ();
+    release_workers ();
+
+    merge_statistics ();
+
+#ifndef NDEBUG
+
+    if (res == 10) {
+
+      // At the end all variables are either backbones or filtered (at
+      // least those in the slice of this process with '--slice').
+
+      {
+        size_t count = 0;
+        for (int idx = 1; idx <= vars; idx++)
+          if (fixed_literal (idx))
+            count++;
+
+        assert (count == statistics.backbones);
+      }
+
+      {
+        size_t count = 0;
+        for (int idx = 1; idx <= vars; idx++)
+          if (!fixed_literal (idx) && !candidate (idx))
+            count++;
+
+        assert (count == statistics.dropped + unprojected);
+      }
+
+      for (int idx = range.begin; idx <= range.end; idx++)
+        assert (!candidate (idx));
+
+      if (slices == 1)
+        assert (statistics.backbones + statistics.dropped + unprojected ==
+                (size_t) vars);
+    }
+
+#endif
+
+    release_candidates ();
+
+    if (checkers && checker) {
+      start_timer (&check_time);
+      verify_claims (checker);
+      stop_timer ();
+    }
+
+    if (checker) {
+      size_t expected = statistics.backbones + statistics.dropped;
+      if (statistics.checked < expected)
+        fatal ("checked %zu literals and not all %zu determined "
+               "variables",
+               statistics.checked, expected);
+      else if (statistics.checked > expected)
+        fatal ("checked %zu literals thus more than all %zu determined "
+               "variables",
+               statistics.checked, expected);
+    }
+  }
+
+  release_fixed ();
+  std::vector<int> ().swap (equivalences);
+  release_checker ();
+  return res;
+}
+
+// The library interface of 'cadiback.hpp' maps its options to the same
+// static variables as the command line options (through the 'name' of the
+// option as the value of the string options) and runs 'extract' on the
+// given solver while holding the 'library' lock.
+
+static std::mutex library;
+
+// Flag options which can be set through the library interface.
+
+static struct {
+  const char *name;
+  const char **flag;
+  const char *implies;
+} library_flags[] = {
+    {"check", &check, 0},
+    {"no-constrain", &no_constrain, 0},
+    {"no-filter", &no_filter, 0},
+    {"no-fixed", &no_fixed, 0},
+#ifndef NFLIP
+    {"no-flip", &no_flip, 0},
+    {"really-flip", &really_flip, 0},
+#endif
+    {"no-inprocessing", &no_inprocessing, 0},
+    {"one-by-one", &one_by_one, 0},
+    {"chunking", &chunking, 0},
+    {"adaptive", &adaptive, 0},
+    {"cores", &cores, 0},
+    {"els", &els, 0},
+    {"probe", &probe, 0},
+    {"big", &big, 0},
+    {"big-no-els", &big_no_els, "big"},
+    {"big-roots", &big_roots, "big"},
+    {"big-lanes", &big_lanes, "big"},
+    {"big-reduce", &big_reduce, "big"},
+};
+
+static bool set_library_option (const char *name, int value) {
+  if (!strcmp (name, "verbosity"))
+    return verbosity = value, true;
+  if (!strcmp (name, "report"))
+    return report = value, true;
+  if (!strcmp (name, "set-phase"))
+    return set_phase = value, true;
+  if (!strcmp (name, "models"))
+    return value >= 0 ? (models = value, true) : false;
+  if (!strcmp (name, "cache"))
+    return value >= 0 ? (cache = value, true) : false;
+  if (!strcmp (name, "budget"))
+    return value >= 0 ? (budget = value, true) : false;
+  if (!strcmp (name, "checkers"))
+    return value >= 0 ? (checkers = value, true) : false;
+  if (!strcmp (name, "models-limit"))
+    return value > 0 ? (models_conflict_limit = value, true) : false;
+  if (!strcmp (name, "core-limit"))
+    return value > 1 ? (initial_core_limit = value, true) : false;
+  if (!strcmp (name, "adaptive-limit"))
+    return value >= 0 ? (initial_constraint_limit = value, true) : false;
+  if (!strcmp (name, "progress"))
+    return value >= 0 ? (progress = value, true) : false;
+  if (!strcmp (name, "threads"))
+    return value > 0 ? (threads = value, true) : false;
+  for (auto &option : library_flags)
+    if (!strcmp (name, option.name)) {
+      *option.flag = value ? option.name : 0;
+      if (value && option.implies)
+        set_library_option (option.implies, 1);
+      return true;
+    }
+  return false;
+}
+
+static void reset_library_options () {
+  for (auto &option : library_flags)
+    *option.flag = 0;
+  verbosity = -1;
+  report = set_phase = false;
+  models = cache = budget = checkers = progress = 0;
+  initial_core_limit = 100;
+  models_conflict_limit = 1000;
+  initial_constraint_limit = 0;
+  threads = 1;
+  slice = slices = 1;
+}
+
+namespace CadiBack {
+
+// State kept between calls to 'extract'.
+
+struct Incremental {
+  bool enabled;                           // Set by option 'incremental'.
+  bool satisfiable;                       // Last 'extract' returned '10'.
+  std::vector<int> clauses;               // Added since the last 'extract'.
+  std::vector<int> assumptions, previous; // Of next and last 'extract'.
+  Witnesses witnesses;
+};
+
+// Remove witness models (and flipped witnesses) which falsify one of the
+// clauses added since the last call to 'extract'.
+
+static void remove_falsified_witnesses (Incremental *incremental) {
+  Witnesses &witnesses = incremental->witnesses;
+  const std::vector<int> &clauses = incremental->clauses;
+  std::vector<int> map (witnesses.models.size (), -1);
+  size_t kept = 0;
+  witnesses.words = 0;
+  for (size_t i = 0; i != witnesses.models.size (); i++) {
+    if (!satisfies (witnesses.models[i], 0, clauses, true))
+      continue;
+    map[i] = kept;
+    witnesses.words += witnesses.models[i].bits.size ();
+    if (kept != i)
+      witnesses.models[kept] = std::move (witnesses.models[i]);
+    kept++;
+  }
+  witnesses.models.resize (kept);
+  size_t j = 0;
+  for (auto pair : witnesses.flipped) {
+    const int model = map[pair.first];
+    if (model < 0)
+      continue;
+    if (!satisfies (witnesses.models[model], pair.second, clauses, true))
+      continue;
+    witnesses.flipped[j++] = {model, pair.second};
+  }
+  witnesses.flipped.resize (j);
+  msg ("kept %zu witness models and %zu flipped witnesses", kept, j);
+}
+
+static bool subset (std::vector<int> a, std::vector<int> b) {
+  std::sort (a.begin (), a.end ());
+  std::sort (b.begin (), b.end ());
+  return std::includes (b.begin (), b.end (), a.begin (), a.end ());
+}
+
+Backbone::Backbone (CaDiCaL::Solver *s)
+    : solver (s), incremental (new Incremental ()) {}
+
+Backbone::~Backbone () { delete incremental; }
+
+void Backbone::add (int lit) {
+  if (incremental->enabled)
+    incremental->clauses.push_back (lit);
+  solver->add (lit);
+}
+
+void Backbone::assume (int lit) {
+  incremental->assumptions.push_back (lit);
+}
+
+bool Backbone::set (const char *name, int value) {
+  if (!strcmp (name, "incremental")) {
+    incremental->enabled = value;
+    return true;
+  }
+  std::lock_guard<std::mutex> guard (library);
+  reset_library_options ();
+  if (!set_library_option (name, value))
+    return false;
+  options.push_back ({name, value});
+  return true;
+}
+
+void Backbone::on_backbone (std::function<void (int)> f) {
+  backbone_callback = f;
+}
+
+void Backbone::on_dropped (std::function<void (int)> f) {
+  dropped_callback = f;
+}
+
+int Backbone::extract () {
+  std::lock_guard<std::mutex> guard (library);
+  reset_library_options ();
+  for (auto &option : options)
+    set_library_option (option.first.c_str (), option.second);
+  error_message.clear ();
+  const char *a, *b;
+  if (incompatible_options (a, b)) {
+    error_message = std::string ("'") + a +
+                    "' does not make sense in combination with '" + b +
+                    "'";
+    return 0;
+  }
+  std::vector<int> previous_backbones;
+  previous_backbones.swap (found);
+  ::backbone_callback = [this] (int lit) {
+    found.push_back (lit);
+    if (backbone_callback)
+      backbone_callback (lit);
+  };
+  ::dropped_callback = dropped_callback;
+  start_real_time = CaDiCaL::absolute_real_time ();
+  ::solver = solver;
+  assumptions = incremental->assumptions;
+  for (auto lit : assumptions)
+    solver->reserve (abs (lit));
+  vars = solver->vars ();
+  determined = 0;
+  reset_milestones ();
+  units.clear ();
+  assumed.clear ();
+  if (!assumptions.empty ()) {
+    assumed.resize (vars + 1);
+    for (auto lit : assumptions)
+      assumed[abs (lit)] = true;
+  }
+  if (incremental->enabled) {
+    remove_falsified_witnesses (incremental);
+    witnesses = &incremental->witnesses;
+    if (incremental->satisfiable &&
+        subset (incremental->previous, incremental->assumptions))
+      reused_backbones.swap (previous_backbones);
+  }
+  int res = ::extract ();
+  merge_statistics ();
+  delete[] workers;
+  workers = 0;
+  ::solver = 0;
+  ::backbone_callback = nullptr;
+  ::dropped_callback = nullptr;
+  witnesses = 0;
+  reused_backbones.clear ();
+  assumptions.clear ();
+  assumed.clear ();
+  incremental->satisfiable = (res == 10);
+  incremental->previous.swap (incremental->assumptions);
+  incremental->assumptions.clear ();
+  incremental->clauses.clear ();
+  return res;
+}
+
+void Backbone::statistics () {
+  std::lock_guard<std::mutex> guard (library);
+  ::solver = solver;
+  print_statistics ();
+  ::solver = 0;
+}
+
+} // namespace CadiBack
+
+#ifndef NMAIN
+
+// Parse the argument of options like '--threads <n>'.
+
+static int parse_positive_number (const char *option, const char *arg) {
+  if (!arg)
+    die ("argument to '%s' missing", option);
+  const char *p = arg;
+  if (!isdigit (*p))
+    die ("invalid argument '%s' to '%s'", arg, option);
+  int res = 0, ch;
+  while (isdigit (ch = *p++)) {
+    int digit = ch - '0';
+    if (INT_MAX / 10 < res || INT_MAX - digit < 10 * res)
+      die ("argument '%s' to '%s' too large", arg, option);
+    res = 10 * res + digit;
+  }
+  if (ch)
+    die ("invalid argument '%s' to '%s'", arg, option);
+  if (!res)
+    die ("invalid zero argument to '%s'", option);
+  return res;
+}
+
+// Parse the argument '<k>/<n>' of '--slice'.
+
+static void parse_slice (const char *option, const char *arg) {
+  if (!arg)
+    die ("argument to '%s' missing", option);
+  int k, n;
+  char tmp;
+  if (sscanf (arg, "%d/%d%c", &k, &n, &tmp) != 2 || k <= 0 || n < k)
+    die ("invalid argument '%s' to '%s' (expected '<k>/<n>')", arg,
+         option);
+  slice = k, slices = n;
+}
+
+// Read the variables to project on for '--project'.  If the file has
+// 'c p show <idx> ... 0' lines (as in projected model counting) only those
+// are used, which allows to give the DIMACS file itself.  Otherwise all
+// numbers in the file (except zeros) are the projected variables.
+
+static void read_projection (const char *path) {
+  FILE *file = fopen (path, "r");
+  if (!file)
+    die ("can not read projection from '%s'", path);
+  std::vector<int> shown, listed;
+  std::string line;
+  bool header = false;
+  size_t lineno = 0;
+  int ch = 0;
+  while (ch != EOF) {
+    line.clear ();
+    while ((ch = getc (file)) != '\n' && ch != EOF)
+      line.push_back (ch);
+    lineno++;
+    const char *p = line.c_str ();
+    int pos = 0;
+    std::vector<int> *variables = &listed;
+    if (p[0] == 'c') {
+      if (sscanf (p, "c p show%n", &pos) != 0 || !pos)
+        continue;
+      variables = &shown;
+    } else if (p[0] == 'p')
+      header = true;
+    if (header && variables == &listed)
+      continue;
+    p += pos;
+    int idx, n;
+    while (sscanf (p, "%d%n", &idx, &n) == 1) {
+      if (idx < 0 || idx > vars)
+        die ("invalid variable '%d' in line %zu of '%s'", idx, lineno,
+             path);
+      if (idx)
+        variables->push_back (idx);
+      p += n;
+    }
+    while (isspace (*p))
+      p++;
+    if (*p)
+      die ("unexpected '%c' in line %zu of '%s'", *p, lineno, path);
+  }
+  fclose (file);
+  if (header && shown.empty ())
+    die ("no 'c p show' lines in projection '%s'", path);
+  projected.assign (vars + 1, false);
+  size_t count = 0;
+  for (auto idx : shown.empty () ? listed : shown)
+    if (!projected[idx])
+      projected[idx] = true, count++;
+  msg ("projecting on %zu variables from '%s'", count, path);
+}
+
+// Read the 'b' and 'd' lines of a checkpoint (or of the output of
+// 'CadiBack') for '--resume' and '--verify'.  Other lines are ignored.
+
+static void read_backbones (const char *path, std::vector<int> &backbones,
+                            std::vector<int> &dropped) {
+  FILE *file = fopen (path, "r");
+  if (!file)
+    die ("can not read backbones from '%s'", path);
+  size_t lineno = 1;
+  int ch;
+  while ((ch = getc (file)) != EOF) {
+    if (ch == 'b' || ch == 'd') {
+      int lit;
+      if (fscanf (file, "%d", &lit) != 1 || lit == INT_MIN ||
+          abs (lit) > vars || (ch == 'd' && lit < 0))
+        die ("invalid '%c' line %zu in '%s'", ch, lineno, path);
+      if (ch == 'd' && !lit)
+        die ("invalid '%c' line %zu in '%s'", ch, lineno, path);
+      if (ch == 'd')
+        dropped.push_back (lit);
+      else if (lit)
+        backbones.push_back (lit);
+      ch = getc (file);
+    }
+    while (ch != '\n' && ch != EOF)
+      ch = getc (file);
+    lineno++;
+  }
+  fclose (file);
+}
+
+static int verify_backbones () {
+  std::vector<int> dropped;
+  read_backbones (verify, claimed_backbones, dropped);
+  msg ("verifying %zu backbones and %zu dropped variables from '%s'",
+       claimed_backbones.size (), dropped.size (), verify);
+  std::vector<bool> determined (vars + 1);
+  for (auto lit : claimed_backbones)
+    determined[abs (lit)] = true;
+  for (auto idx : dropped) {
+    determined[idx] = true;
+    claimed_models.push_back (idx);
+    claimed_models.push_back (-idx);
+  }
+  const size_t num_backbones = claimed_backbones.size ();
+  const size_t num_dropped = dropped.size ();
+  start_timer (&check_time);
+  int res = solver->solve ();
+  if (res == 20 && (num_backbones || num_dropped))
+    fatal ("formula unsatisfiable but '%s' claims backbones", verify);
+  verify_claims (solver);
+  stop_timer ();
+  int undetermined = 0;
+  for (int idx = 1; idx <= vars; idx++)
+    if (!determined[idx])
+      undetermined++;
+  msg ("verified %zu backbones and %zu dropped variables "
+       "(%d variables undetermined)",
+       num_backbones, num_dropped, undetermined);
+  return res;
+}
+
+// Read the assumption cubes for '--cubes'.
+
+static std::vector<std::vector<int>> read_cubes (const char *path) {
+  FILE *file = fopen (path, "r");
+  if (!file)
+    die ("can not read cubes from '%s'", path);
+  std::vector<std::vector<int>> res;
+  std::vector<int> cube;
+  int ch;
+  while ((ch = getc (file)) != EOF) {
+    if (ch == 'c') {
+      while ((ch = getc (file)) != '\n' && ch != EOF)
+        ;
+      continue;
+    }
+    if (isspace (ch))
+      continue;
+    ungetc (ch, file);
+    int lit;
+    if (fscanf (file, "%d", &lit) != 1)
+      die ("invalid literal in cube %zu of '%s'", res.size () + 1, path);
+    if (lit == INT_MIN || abs (lit) > vars)
+      die ("invalid literal '%d' in cube %zu of '%s'", lit,
+           res.size () + 1, path);
+    if (lit)
+      cube.push_back (lit);
+    else {
+      std::sort (cube.begin (), cube.end ());
+      res.push_back (std::move (cube));
+      cube.clear ();
+    }
+  }
+  if (!cube.empty ())
+    die ("zero missing after last cube in '%s'", path);
+  fclose (file);
+  return res;
+}
+
+// Write the events recorded for '--trace'.  The 'call' field is the
+// position of the event in the trace (in the order calls finished).
+
+static void write_trace_fields (FILE *file, size_t call,
+                                const TraceEvent &event) {
+  fprintf (file,
+           "\"call\":%zu,\"worker\":%d,\"size\":%d,\"result\":%d,"
+           "\"process\":%.6f,\"dropped\":%zu,\"filtered\":%zu,"
+           "\"flipped\":%zu,\"fixed\":%zu,\"backbones\":%zu",
+           call, event.worker, event.size, event.res, event.process,
+           event.dropped, event.filtered, event.flipped, event.fixed,
+           event.backbones);
+}
+
+static void write_trace () {
+  FILE *file = fopen (trace, "w");
+  if (!file)
+    die ("can not write trace to '%s'", trace);
+  const size_t size = trace_events.size ();
+  if (!strcmp (trace_format, "csv")) {
+    fputs ("call,worker,kind,size,result,start,wall,process,"
+           "dropped,filtered,flipped,fixed,backbones\n",
+           file);
+    for (size_t i = 0; i != size; i++) {
+      const TraceEvent &event = trace_events[i];
+      fprintf (file,
+               "%zu,%d,%s,%d,%d,%.6f,%.6f,%.6f,%zu,%zu,%zu,%zu,%zu\n",
+               i + 1, event.worker, event.kind, event.size, event.res,
+               event.start, event.wall, event.process, event.dropped,
+               event.filtered, event.flipped, event.fixed,
+               event.backbones);
+    }
+  } else if (!strcmp (trace_format, "json")) {
+    fputs ("[\n", file);
+    for (size_t i = 0; i != size; i++) {
+      const TraceEvent &event = trace_events[i];
+      fprintf (file, "{\"kind\":\"%s\",\"start\":%.6f,\"wall\":%.6f,",
+               event.kind, event.start, event.wall);
+      write_trace_fields (file, i + 1, event);
+      fputs (i + 1 == size ? "}\n" : "},\n", file);
+    }
+    fputs ("]\n", file);
+  } else {
+    assert (!strcmp (trace_format, "chrome"));
+    fputs ("{\"traceEvents\":[\n", file);
+    for (size_t i = 0; i != size; i++) {
+      const TraceEvent &event = trace_events[i];
+      const int tid =
+          event.worker < 0 ? threads - 1 - event.worker : event.worker;
+      fprintf (file,
+               "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+               "\"ts\":%.0f,\"dur\":%.0f,\"args\":{",
+               event.kind, tid, 1e6 * event.start, 1e6 * event.wall);
+      write_trace_fields (file, i + 1, event);
+      fputs (i + 1 == size ? "}}\n" : "}},\n", file);
+    }
+    fputs ("]}\n", file);
+  }
+  fclose (file);
+  msg ("wrote %zu trace events in '%s' format to '%s'", size,
+       trace_format, trace);
+}
+
+// Determine the backbone under each cube.  All cubes share the witness
+// models and the backbones of satisfiable cubes are kept in order to reuse
+// them for super-sets.  A cube with an unsatisfiable subset is determined
+// to be unsatisfiable without calling the solver.  Returns '10' if at
+// least one cube is satisfiable.  The counts and the estimated time of
+// '--progress' lines and the backbone milestones are reset for each cube.
+
+static int extract_cubes () {
+
+  std::vector<std::vector<int>> cube = read_cubes (cubes);
+  msg ("read %zu cubes from '%s'", cube.size (), cubes);
+
+  std::vector<std::vector<int>> backbones (cube.size ());
+  std::vector<int> status (cube.size ());
+  Witnesses shared;
+  Statistics total = Statistics ();
+  size_t id = 0;
+  int res = 20;
+
+  backbone_callback = [&] (int lit) {
+    backbones[id].push_back (lit);
+    if (!no_print)
+      write_record ('b', id + 1, lit);
+  };
+  if (print_dropped)
+    dropped_callback = [&] (int idx) { write_record ('d', id + 1, idx); };
+
+  for (id = 0; id != cube.size (); id++) {
+    const std::vector<int> &current = cube[id];
+    reused_backbones.clear ();
+    int tmp = 0;
+    for (size_t other = 0; !tmp && other != id; other++)
+      if (std::includes (current.begin (), current.end (),
+                         cube[other].begin (), cube[other].end ())) {
+        if (status[other] == 20)
+          tmp = 20;
+        else
+          for (auto lit : backbones[other])
+            reused_backbones.push_back (lit);
+      }
+    if (tmp)
+      msg ("cube %zu is a super-set of an unsatisfiable cube", id + 1);
+    else {
+      line ();
+      msg ("determining backbone under cube %zu of size %zu", id + 1,
+           current.size ());
+      assumptions = current;
+      assumed.assign (vars + 1, false);
+      for (auto lit : current)
+        assumed[abs (lit)] = true;
+      witnesses = &shared;
+      determined = 0;
+      reset_milestones ();
+      units.clear ();
+      tmp = extract ();
+      merge_statistics ();
+      add_statistics (total, statistics);
+      delete[] workers;
+      workers = 0;
+    }
+    status[id] = tmp;
+    if (tmp == 10) {
+      if (!no_print)
+        write_record ('b', id + 1, 0);
+      res = 10;
     }
-    if (candidates.empty ())
-      break;
-    for (int u : tree)
-      marked[u] = false;
-    for (int u : backbones)
-      marked[u] = true;
-    backbones.clear ();
-    tree.clear ();
+    write_string ("s ");
+    write_number (id + 1);
+    write_string (tmp == 10 ? " SATISFIABLE\n" : " UNSATISFIABLE\n");
+    flush_output ();
+  }
+
+  backbone_callback = nullptr;
+  dropped_callback = nullptr;
+  witnesses = 0;
+  reused_backbones.clear ();
+  assumptions.clear ();
+  assumed.clear ();
+  statistics = total;
+  line ();
+  return res;
+}
+
+// Read the next request for '--server' from '<stdin>'.  Clauses are added
+// to the solver (and to 'clauses') until an 'a' line with a cube of
+// assumptions terminated by '0' is found, which is returned in 'cube'.
+// Returns 'false' at the end of the input (after pending clauses).
+
+static bool read_request (size_t id, std::vector<int> &clauses,
+                          std::vector<int> &cube) {
+  cube.clear ();
+  bool assuming = false, open = false;
+  int ch;
+  while ((ch = getc (stdin)) != EOF) {
+    if (!assuming && !open && ch == 'c') {
+      while ((ch = getc (stdin)) != '\n' && ch != EOF)
+        ;
+      continue;
+    }
+    if (!assuming && !open && ch == 'a') {
+      assuming = true;
+      continue;
+    }
+    if (isspace (ch))
+      continue;
+    ungetc (ch, stdin);
+    int lit;
+    if (scanf ("%d", &lit) != 1 || lit == INT_MIN || abs (lit) == INT_MAX)
+      die ("invalid literal in request %zu", id);
+    if (assuming) {
+      if (!lit) {
+        std::sort (cube.begin (), cube.end ());
+        return true;
+      }
+      cube.push_back (lit);
+    } else {
+      solver->add (lit);
+      clauses.push_back (lit);
+      open = lit;
+    }
+  }
+  if (assuming || open)
+    die ("zero missing at end of request %zu", id);
+  return false;
+}
+
+// With '--server' the solver is kept for a sequence of requests read from
+// '<stdin>', each consisting of clauses added for good and a query under
+// the cube of assumptions of an 'a' line.  The answer has the same format
+// as for '--cubes' and is flushed immediately, so requests can be written
+// without waiting for the answers of previous ones.  As clauses are only
+// added, witness models satisfying the new clauses are still models, the
+// backbones of the previous query are still backbones and it remains
+// unsatisfiable for a super-set of its assumptions.
+
+static int extract_server () {
+
+  CadiBack::Incremental state = CadiBack::Incremental ();
+  std::vector<int> cube, previous_backbones, current_backbones;
+  Statistics total = Statistics ();
+  bool answered = false;
+  size_t id = 1;
+  int res = 20;
+
+  backbone_callback = [&] (int lit) {
+    current_backbones.push_back (lit);
+    if (!no_print)
+      write_record ('b', id, lit);
+  };
+  if (print_dropped)
+    dropped_callback = [&] (int idx) { write_record ('d', id, idx); };
+
+  msg ("waiting for requests on '<stdin>'");
+
+  for (; read_request (id, state.clauses, cube); id++) {
+    int tmp = 0;
+    for (auto lit : cube)
+      solver->reserve (abs (lit));
+    vars = solver->vars ();
+    if (answered && !state.satisfiable &&
+        CadiBack::subset (state.previous, cube)) {
+      msg ("request %zu extends an unsatisfiable request", id);
+      tmp = 20;
+    } else {
+      line ();
+      msg ("determining backbone of request %zu under %zu assumptions "
+           "after %zu new literals",
+           id, cube.size (), state.clauses.size ());
+      CadiBack::remove_falsified_witnesses (&state);
+      witnesses = &state.witnesses;
+      reused_backbones.clear ();
+      if (state.satisfiable && CadiBack::subset (state.previous, cube))
+        reused_backbones.swap (previous_backbones);
+      current_backbones.clear ();
+      assumptions = cube;
+      assumed.assign (vars + 1, false);
+      for (auto lit : cube)
+        assumed[abs (lit)] = true;
+      determined = 0;
+      reset_milestones ();
+      units.clear ();
+      tmp = extract ();
+      merge_statistics ();
+      add_statistics (total, statistics);
+      delete[] workers;
+      workers = 0;
+      previous_backbones.swap (current_backbones);
+    }
+    state.clauses.clear ();
+    state.satisfiable = (tmp == 10);
+    state.previous = cube;
+    answered = true;
+    if (tmp == 10) {
+      if (!no_print)
+        write_record ('b', id, 0);
+      res = 10;
+    }
+    write_string ("s ");
+    write_number (id);
+    write_string (tmp == 10 ? " SATISFIABLE\n" : " UNSATISFIABLE\n");
+    flush_output ();
   }
+  msg ("answered %zu requests", id - 1);
+
+  backbone_callback = nullptr;
+  dropped_callback = nullptr;
+  witnesses = 0;
+  reused_backbones.clear ();
+  assumptions.clear ();
+  assumed.clear ();
+  statistics = total;
+  line ();
+  return res;
 }
 
 int main (int argc, char **argv) {
 
+  start_real_time = CaDiCaL::absolute_real_time ();
+  const char *core_limit = 0, *adaptive_limit = 0, *checkpoint_option = 0;
+  const char *flush_option = 0, *models_option = 0;
+
   for (int i = 1; i != argc; i++) {
     const char *arg = argv[i];
     if (!strcmp (arg, "-h")) {
@@ -1138,6 +5212,8 @@ int main (int argc, char **argv) {
       verbosity = INT_MAX;
     } else if (!strcmp (arg, "-n") || !strcmp (arg, "--no-print")) {
       no_print = arg;
+    } else if (!strcmp (arg, "-p") || !strcmp (arg, "--print-dropped")) {
+      print_dropped = arg;
     } else if (!strcmp (arg, "-q") || !strcmp (arg, "--quiet")) {
       verbosity = -1;
     } else if (!strcmp (arg, "-r") || !strcmp (arg, "--report")) {
@@ -1160,24 +5236,118 @@ int main (int argc, char **argv) {
       no_flip = arg;
 #else
     NO_CADICAL_SUPPORT_FOR_FLIPPING:
-      die ("invalid option '%s' (CaDiCaL does not support flipping)" arg);
+      die ("invalid option '%s' (CaDiCaL does not support flipping)", arg);
 #endif
     } else if (!strcmp (arg, "--really-flip")) {
 #ifndef NFLIP
       really_flip = arg;
 #else
       goto NO_CADICAL_SUPPORT_FOR_FLIPPING;
+#endif
+    } else if (!strcmp (arg, "--bulk-flip")) {
+#ifndef NFLIP
+      bulk_flip = arg;
+#else
+      goto NO_CADICAL_SUPPORT_FOR_FLIPPING;
 #endif
     } else if (!strcmp (arg, "--no-inprocessing")) {
       no_inprocessing = arg;
+    } else if (!strcmp (arg, "--no-mmap")) {
+      no_mmap = arg;
     } else if (!strcmp (arg, "--one-by-one")) {
       one_by_one = arg;
     } else if (!strcmp (arg, "--cores")) {
       cores = arg;
     } else if (!strcmp (arg, "--chunking")) {
       chunking = arg;
+    } else if (!strcmp (arg, "--adaptive")) {
+      adaptive = arg;
+    } else if (!strcmp (arg, "--core-limit")) {
+      initial_core_limit = parse_positive_number (arg, argv[++i]);
+      if (initial_core_limit < 2)
+        die ("invalid argument '%d' to '%s' (expected at least '2')",
+             initial_core_limit, arg);
+      core_limit = arg;
+    } else if (!strcmp (arg, "--adaptive-limit")) {
+      initial_constraint_limit = parse_positive_number (arg, argv[++i]);
+      adaptive_limit = arg;
     } else if (!strcmp (arg, "--set-phase")) {
       set_phase = true;
+    } else if (!strcmp (arg, "--order")) {
+      if (!(order = argv[++i]))
+        die ("argument to '%s' missing", arg);
+      if (!strcmp (order, "index"))
+        order = 0;
+      else if (strcmp (order, "occurrences") && strcmp (order, "binary"))
+        die ("invalid order '%s' in '%s %s'", order, arg, order);
+    } else if (!strcmp (arg, "--checkpoint")) {
+      if (!(checkpoint = argv[++i]))
+        die ("argument to '%s' missing", arg);
+    } else if (!strcmp (arg, "--checkpoint-interval")) {
+      checkpoint_interval = parse_positive_number (arg, argv[++i]);
+      checkpoint_option = arg;
+    } else if (!strcmp (arg, "--resume")) {
+      if (!(resume = argv[++i]))
+        die ("argument to '%s' missing", arg);
+    } else if (!strcmp (arg, "--flush")) {
+      const char *policy = argv[++i];
+      if (!policy)
+        die ("argument to '%s' missing", arg);
+      if (!strcmp (policy, "lines"))
+        flush_policy = FLUSH_LINES;
+      else if (!strcmp (policy, "calls"))
+        flush_policy = FLUSH_CALLS;
+      else if (!strcmp (policy, "time"))
+        flush_policy = FLUSH_TIME;
+      else
+        die ("invalid flush policy '%s' in '%s %s'", policy, arg, policy);
+    } else if (!strcmp (arg, "--flush-interval")) {
+      flush_interval = parse_positive_number (arg, argv[++i]);
+      flush_option = arg;
+    } else if (!strcmp (arg, "--binary")) {
+      binary = arg;
+    } else if (!strcmp (arg, "--models")) {
+      models = parse_positive_number (arg, argv[++i]);
+    } else if (!strcmp (arg, "--models-limit")) {
+      models_conflict_limit = parse_positive_number (arg, argv[++i]);
+      models_option = arg;
+    } else if (!strcmp (arg, "--cache")) {
+      cache = parse_positive_number (arg, argv[++i]);
+    } else if (!strcmp (arg, "--checkers")) {
+      checkers = parse_positive_number (arg, argv[++i]);
+    } else if (!strcmp (arg, "--verify")) {
+      if (!(verify = argv[++i]))
+        die ("argument to '%s' missing", arg);
+    } else if (!strcmp (arg, "--trace")) {
+      if (!(trace = argv[++i]))
+        die ("argument to '%s' missing", arg);
+    } else if (!strcmp (arg, "--trace-format")) {
+      if (!(trace_format = argv[++i]))
+        die ("argument to '%s' missing", arg);
+      if (strcmp (trace_format, "csv") && strcmp (trace_format, "json") &&
+          strcmp (trace_format, "chrome"))
+        die ("invalid trace format '%s' in '%s %s'", trace_format, arg,
+             trace_format);
+    } else if (!strcmp (arg, "--budget")) {
+      budget = parse_positive_number (arg, argv[++i]);
+    } else if (!strcmp (arg, "--progress")) {
+      progress = parse_positive_number (arg, argv[++i]);
+    } else if (!strcmp (arg, "--threads")) {
+      threads = parse_positive_number (arg, argv[++i]);
+    } else if (!strcmp (arg, "--slice")) {
+      parse_slice (arg, argv[++i]);
+    } else if (!strcmp (arg, "--project")) {
+      if (!(project = argv[++i]))
+        die ("argument to '%s' missing", arg);
+    } else if (!strcmp (arg, "--server")) {
+      server = arg;
+    } else if (!strcmp (arg, "--cubes")) {
+      if (!(cubes = argv[++i]))
+        die ("argument to '%s' missing", arg);
+    } else if (!strcmp (arg, "--els")) {
+      els = arg;
+    } else if (!strcmp (arg, "--probe")) {
+      probe = arg;
     } else if (!strcmp (arg, "--big")) {
       big = arg;
     } else if (!strcmp (arg, "--big-no-els")) {
@@ -1188,6 +5358,14 @@ int main (int argc, char **argv) {
       big_roots = arg;
       if (!big)
         big = arg;
+    } else if (!strcmp (arg, "--big-lanes")) {
+      big_lanes = arg;
+      if (!big)
+        big = arg;
+    } else if (!strcmp (arg, "--big-reduce")) {
+      big_reduce = arg;
+      if (!big)
+        big = arg;
     } else if (!strcmp (arg, "--default")) {
       no_filter = no_fixed = no_inprocessing = one_by_one = 0;
 #ifndef NFLIP
@@ -1220,21 +5398,75 @@ int main (int argc, char **argv) {
   } else if (force)
     die ("'%s' does not make sense without backbone file argument", force);
 
-  if (one_by_one && chunking)
-    die ("'%s' does not make sense with '%s'", chunking, one_by_one);
+  if (no_print && print_dropped)
+    die ("'%s' does not make sense with '%s'", print_dropped, no_print);
+
+  if (no_print && binary)
+    die ("'%s' does not make sense with '%s'", binary, no_print);
 
-  if (one_by_one && no_constrain)
-    die ("'%s' does not make sense with '%s'", no_constrain, one_by_one);
+  if (cubes && binary)
+    die ("'%s' does not make sense with '--cubes'", binary);
+
+  if (cubes && checkpoint)
+    die ("'--checkpoint' does not make sense with '--cubes'");
+
+  if (cubes && resume)
+    die ("'--resume' does not make sense with '--cubes'");
+
+  if (verify && (cubes || resume || checkpoint))
+    die ("'--verify' does not make sense with '%s'",
+         cubes ? "--cubes" : resume ? "--resume" : "--checkpoint");
+
+  if (server && (cubes || verify || resume || checkpoint))
+    die ("'--server' does not make sense with '%s'",
+         cubes    ? "--cubes"
+         : verify ? "--verify"
+         : resume ? "--resume"
+                  : "--checkpoint");
+
+  if (server && binary)
+    die ("'%s' does not make sense with '--server'", binary);
+
+  // Activation variables would clash with new variables of requests.
+
+  if (server && no_constrain)
+    die ("'%s' does not make sense with '--server'", no_constrain);
 
 #ifndef NFLIP
-  if (no_flip && really_flip)
-    die ("'%s' does not make sense in combination with '%s'", really_flip,
-         no_flip);
+  // The copied clauses would miss those added by requests.
+
+  if (server && bulk_flip)
+    die ("'%s' does not make sense with '--server'", bulk_flip);
 #endif
 
-  if (big_no_els && big_roots)
-    die ("'%s' does not make sense in combination with '%s'", big_no_els,
-         big_roots);
+  if (server && (!files.dimacs.path || !strcmp (files.dimacs.path, "-")))
+    die ("'--server' reads requests from '<stdin>' and thus "
+         "needs a DIMACS file");
+
+  if (checkers && !check && !verify)
+    die ("'--checkers' does not make sense without '--check'");
+
+  if (models_option && !models)
+    die ("'%s' does not make sense without '--models'", models_option);
+
+  if (flush_option && flush_policy != FLUSH_TIME)
+    die ("'%s' does not make sense without '--flush time'", flush_option);
+
+  if (checkpoint_option && !checkpoint)
+    die ("'%s' does not make sense without '--checkpoint'",
+         checkpoint_option);
+
+  if (core_limit && !cores)
+    die ("'%s' does not make sense without '--cores'", core_limit);
+
+  if (adaptive_limit && !adaptive)
+    die ("'%s' does not make sense without '--adaptive'", adaptive_limit);
+
+  {
+    const char *a, *b;
+    if (incompatible_options (a, b))
+      die ("'%s' does not make sense in combination with '%s'", a, b);
+  }
 
   msg ("CadiBack BackBone Extractor");
   msg ("Copyright (c) 2023 Armin Biere University of Freiburg");
@@ -1254,8 +5486,25 @@ int main (int argc, char **argv) {
   }
   msg ("writing backbones to '%s'", files.backbone.path);
 
+  if (binary)
+    msg ("writing backbones in binary format by '%s'", binary);
+
+  if (checkpoint)
+    msg ("writing checkpoints every %d seconds to '%s'",
+         checkpoint_interval, checkpoint);
+
+  if (progress)
+    msg ("reporting progress every %d seconds by '--progress'", progress);
+
+  if (flush_policy == FLUSH_LINES)
+    msg ("flushing backbones after each line (change with '--flush')");
+  else if (flush_policy == FLUSH_CALLS)
+    msg ("flushing backbones after each solver call by '--flush calls'");
+  else
+    msg ("flushing backbones every %d seconds by '--flush time'",
+         flush_interval);
+
   if (check) {
-    checker = new CaDiCaL::Solver ();
     msg ("checking models with copy of main solver by '%s'", check);
   } else
     msg ("not checking models and backbones "
@@ -1266,6 +5515,12 @@ int main (int argc, char **argv) {
   else
     msg ("core based preprocessing disabled (enable with '--cores')");
 
+  if (els && !big)
+    msg ("deciding equivalent candidates together by '%s'", els);
+
+  if (probe)
+    msg ("probing candidates for failed literals by '%s'", probe);
+
   if (no_constrain)
     msg ("using 'constrain' interface disabled by '%s'", no_constrain);
   else
@@ -1291,6 +5546,13 @@ int main (int argc, char **argv) {
     msg ("will actually flip flippable literals by '%s'", really_flip);
   else
     msg ("only dropping flippable candidates without flipping them");
+
+  if (bulk_flip)
+    msg ("checking flippable candidates on clause copy by '%s'",
+         bulk_flip);
+  else
+    msg ("asking solver for flippable candidates "
+         "(avoid with '--bulk-flip')");
 #endif
 
   if (no_inprocessing)
@@ -1309,18 +5571,46 @@ int main (int argc, char **argv) {
   else
     msg ("phases picked by SAT solver "
          "(force with '--set-phase')");
+
+  if (models)
+    msg ("searching up to %d additional models by '--models' "
+         "limited to %d conflicts",
+         models, models_conflict_limit);
+  else
+    msg ("one model per satisfiable call (more with '--models')");
+
+  if (cache)
+    msg ("caching the last %d models by '--cache'", cache);
+  else
+    msg ("no model cache (enable with '--cache')");
+
+  if (budget)
+    msg ("limiting solver calls to %d conflicts by '--budget'", budget);
+  else
+    msg ("no conflict limit for solver calls (set with '--budget')");
+
+  if (order)
+    msg ("trying candidates by '--order %s'", order);
+  else
+    msg ("trying candidates by index (change with '--order')");
+
+  if (threads > 1)
+    msg ("using %d solver copies in parallel by '--threads'", threads);
+  else
+    msg ("using a single solver (use more with '--threads')");
+
+  if (slices > 1)
+    msg ("only determining candidates in slice %d of %d by '--slice'",
+         slice, slices);
+  else
+    msg ("determining all candidates (restrict with '--slice')");
+
+  if (print_dropped)
+    msg ("printing dropped candidates by '%s'", print_dropped);
   line ();
 
   solver = new CaDiCaL::Solver ();
-  if (no_inprocessing)
-    solver->set ("inprocessing", 0);
-
-  if (verbosity < 0)
-    solver->set ("quiet", 1);
-  else if (verbosity > 1)
-    solver->set ("verbose", verbosity - 2);
-  if (report || verbosity > 1)
-    solver->set ("report", 1);
+  configure_solver (solver);
 
   int res = 0;
   {
@@ -1328,10 +5618,11 @@ int main (int argc, char **argv) {
     CaDiCaL::Signal::set (&handler);
     dbg ("initialized solver");
     {
-      const char *err;
+      const char *err = 0;
       if (files.dimacs.path && strcmp (files.dimacs.path, "-")) {
         msg ("reading from '%s'", files.dimacs.path);
-        err = solver->read_dimacs (files.dimacs.path, vars);
+        if (no_mmap || !read_mapped_dimacs (files.dimacs.path, vars))
+          err = solver->read_dimacs (files.dimacs.path, vars);
       } else {
         msg ("reading from '<stdin>");
         err = solver->read_dimacs (stdin, "<stdin>", vars);
@@ -1349,436 +5640,40 @@ int main (int argc, char **argv) {
     }
     msg ("found %d variables", vars);
 
-    if (big) {
-      msg ("starting BIG search after %.2f seconds", time ());
-      std::vector<int> f, e;
-      const int num_nodes = 2 * vars;
-      start_timer (&big_read_time);
-      big_extract (num_nodes, f, e);
-      marked = new char[num_nodes];
-      if (!marked)
-        fatal ("out-of-memory allocating marked flag for BIG nodes");
-      for (int u = 0; u < num_nodes; u++)
-        marked[u] = false;
-      stop_timer ();
-
-      // Keeps track of the ELS groups.
-      // If the representative of a group of literals is found to be a
-      // backbone all literals in the group need to be marked as a backbone.
-      std::vector<int> extension;
-      start_timer (&big_els_time);
-      if (!big_no_els)
-        res = big_els (f, e, extension);
-      stop_timer ();
-
-      if (res) {
-        assert (res == 20);
-        msg ("Unsatisfiability determined by ELS");
-        printf ("s UNSATISFIABLE\n");
-        if (files.backbone.close)
-          fclose (files.backbone.file);
-        print_statistics ();
-        if (check)
-          assert (solve () == 20);
-        dbg ("deleting solver");
-        CaDiCaL::Signal::reset ();
-        delete solver;
-        line ();
-        msg ("exit %d", res);
-        return res;
-      }
-
-      fixed = new int[vars + 1];
-      if (!fixed)
-        fatal ("out-of-memory allocating backbone result array");
-      for (int idx = 1; idx <= vars; idx++)
-        fixed[idx] = 0;
-
-      start_timer (&big_search_time);
-      if (big_roots)
-        big_backbone<true> (f, e);
-      else
-        big_backbone<false> (f, e);
-      stop_timer ();
-      if (check) {
-        start_timer (&big_check_time);
-        std::vector<int> backbone, backbone_base, dummy;
-        if (!big_no_els || !big_els (f, e, dummy, true)) {
-          for (int idx = 1; idx <= vars; idx++) {
-            if (fixed[idx])
-              backbone.push_back (fixed[idx]);
-            fixed[idx] = 0;
-          }
-          for (size_t u = 0; u < f.size () - 1; u++)
-            marked[u] = false;
-          statistics.backbones = 0, statistics.big_backbones = 0;
-          big_backbone_base (f, e);
-          for (int idx = 1; idx <= vars; idx++)
-            if (fixed[idx])
-              backbone_base.push_back (fixed[idx]);
-          assert (backbone == backbone_base);
-        }
-        stop_timer ();
-      }
-
-      // extending backbones to their scc
-      start_timer (&big_extension_time);
-      int fixed_val = 0;
-      for (int u : extension) {
-        if (u == -1)
-          fixed_val = 0;
-        else if (fixed_val)
-          big_backbone_node (u);
-        else {
-          const int val = fixed[var (u)];
-          if (val == lit (u))
-            fixed_val = val;
-        }
-      }
-      stop_timer ();
-
-      msg ("BIG found %ld backbones after %.2f seconds",
-           statistics.big_backbones, time ());
-      delete[] marked;
-    }
-
-    // Determine first model or that formula is unsatisfiable.
-
-    line ();
-    msg ("starting solving after %.2f seconds", time ());
-    res = solve ();
-    assert (res == 10 || res == 20);
+    if (project)
+      read_projection (project);
 
-    if (checker) {
-      dbg ("copying checker after first model");
-      solver->copy (*checker);
+    if (resume) {
+      read_backbones (resume, resumed_backbones, resumed_dropped);
+      msg ("resuming %zu backbones and %zu dropped candidates from '%s'",
+           resumed_backbones.size (), resumed_dropped.size (), resume);
     }
 
-    if (res == 10) {
-
-      msg ("solver determined first model after %.2f seconds", time ());
-      if (report || verbosity > 1)
-        line ();
-
-      candidates = new int[vars + 1];
-      if (!candidates)
-        fatal ("out-of-memory allocating backbone candidate array");
-
-      if (!big) {
-        fixed = new int[vars + 1];
-        if (!fixed)
-          fatal ("out-of-memory allocating backbone result array");
-      }
-
-      if (!one_by_one) {
-        constraint = new int[vars];
-        if (!constraint)
-          fatal ("out-of-memory allocating constraint stack");
-      }
-
-      if (cores) {
-        core = new int[vars];
-        if (!core)
-          fatal ("out-of-memory allocating literal core stack");
-      }
-
-      // Initialize the candidate backbone literals with first model.
-
-      for (int idx = 1; idx <= vars; idx++) {
-        int lit = solver->val (idx) < 0 ? -idx : idx; // Legacy support.
-        assert (lit == idx || lit == -idx);
-        if (!big) {
-          candidates[idx] = lit;
-          fixed[idx] = 0;
-        } else if (fixed[idx])
-          candidates[idx] = 0;
-        else
-          candidates[idx] = lit;
-        // If enabled by '--set-phase' set opposite value as default
-        // decision phase.  This seems to have  negative effects with and
-        // without using 'constrain' and thus is disabled by default.
-
-        if (set_phase)
-          solver->phase (-lit);
-      }
-
-      // Use first model to flip as many literals as possible which if
-      // successful is cheaper than calling the SAT solver.
-
-      try_to_flip_remaining (1);
-
-      // Now go over all variables in turn and check whether they still
-      // are candidates for being a backbone variables.  Each step of this
-      // loop either drops at least one candidate or determines at least
-      // one candidate to be a backbone (or skips already dropped
-      // variables).
-
-      int activation_variable = vars; // New variables if '--no-contrain'.
-      int constraint_limit = INT_MAX; // Adapted dynamically using 'last'.
-      int core_limit = 100;           // TODO make this configurable.
-      int last = 10;                  // Last solver result.
-
-      for (int idx = 1; idx <= vars; idx++) {
-
-        // First skip variables that have been dropped as candidates
-        // before.
-
-        int lit = candidates[idx];
-        if (!lit)
-          continue;
-
-        // With 'constrain' we might drop another literal but not 'idx'
-        // and in that case simply restart checking 'idx' for being a
-        // candidate (same applies if 'cores' are enabled).
-
-      TRY_SAME_CANDIDATE_AGAIN:
-
-        assert (lit == candidates[idx]);
-        assert (lit);
-
-        // If not disabled by '--no-fixed' filter root-level fixed
-        // literals.
-
-        if (!no_fixed && fix_candidate (idx))
-          continue;
-
-        if (cores) {
-
-          assert (core_limit > 1);
-          int assumed = 0;
-
-          assert (assumed < vars);
-          core[assumed++] = -lit;
-
-          for (int other = idx + 1; other <= vars; other++) {
-            int lit_other = candidates[other];
-            if (!lit_other)
-              continue;
-            if (!no_fixed && fix_candidate (other))
-              continue;
-            assert (assumed < vars);
-            core[assumed++] = -lit_other;
-
-            if (assumed == core_limit)
-              break;
-          }
-
-          bool progress = false;
-
-          while (assumed) {
-
-            dbg ("core based approach assumes %d literals", assumed);
-
-            for (int i = 0; i != assumed; i++)
-              solver->assume (core[i]);
-
-            int tmp = solve ();
-            if (tmp == 10) {
-
-              dbg ("all %d negatively assumed backbone candidates "
-                   "can be dropped",
-                   assumed);
-
-              for (int i = 0; i != assumed; i++)
-                drop_candidate (abs (core[i]));
-
-              statistics.failed += assumed;
-
-              assert (INT_MAX - assumed >= idx);
-              filter_candidates (idx);
-              progress = true;
-              assumed = -1;
-              break;
-            }
-
-            assert (tmp == 20);
-
-            int num_failed = 0;
-            int failed_lit = 0;
-            int remain = 0;
-
-            for (int i = 0; i != assumed; i++) {
-              int other = core[i];
-              bool other_failed = solver->failed (other);
-              if (other_failed) {
-                failed_lit = other;
-                num_failed++;
-              }
-              int other_idx = abs (other);
-              assert (candidates[other_idx] == -other);
-              if (!no_fixed && fix_candidate (other_idx)) {
-                progress = true;
-                continue;
-              }
-              if (!other_failed)
-                core[remain++] = other;
-            }
-
-            dbg ("failed literal core of size %d", num_failed);
-            assert (remain < assumed);
-            assert (num_failed);
-
-            if (num_failed == 1 && backbone_variable (abs (failed_lit))) {
-              statistics.failed++;
-              progress = true;
-            }
-
-            assumed = remain;
-            dbg ("reducing core assumptions to complement of size %d",
-                 remain);
-          }
-
-          if (progress) {
-
-            dbg ("continuing with next core");
-
-            if (candidates[idx])
-              goto TRY_SAME_CANDIDATE_AGAIN;
-            else
-              continue;
-          }
-
-          dbg ("falling back to iterative approach");
-        }
-
-        // If not disabled through '--one-by-one' use the 'constrain'
-	// optimization which assumes the disjunction of the negation of all
-	// remaining possible backbone candidate literals.  By default this
-	// uses the 'constrain' API call described in our FMCAD'21 paper
-	// (unless '--no-constrain' is specified in which case we use
-	// activation literals as in 'MiniBones')).
-
-        // If the remaining backbone candidates are all actually backbones
-	// then only one such call can be enough to prove it. Otherwise
-	// without 'constraints' we need as many solver calls as there are
-	// candidates.  Without constrain this puts heavy load on the
-	// 'restore' algorithm which in some instances ended up taking 99%
-	// of the running time.
-
-	// It seems reasonable to limit the size of the constraint (the
-	// number of negated candidate literals where one is assumed to be
-	// flippable) by some sort of chunking.  In contrast to earlier work
-	// in 'MiniBones' we adapt the limit during chunking as follows.  As
-	// long constraint was unsatisfiable (and all the contained
-	// candidates are thus fixed) we increase the limit on the
-	// considered candidates in the constraint exponentially (by the
-	// hard coded factor 10).  If the call returns a model we go back to
-	// checking candidates one-by-one.  If the following call returns
-	// unsatisfiable, we limit the size of the constraint to 10
-	// candidates next time etc.
-
-        if (!one_by_one && chunking) {
-          if (last == 20)
-            constraint_limit = (constraint_limit < INT_MAX / 10)
-                                   ? 10 * constraint_limit
-                                   : INT_MAX;
-          else
-            constraint_limit = 1;
-        }
-
-        if (!one_by_one && last == 20) {
-
-          assert (constraint_limit > 1);
-          int assumed = 0;
-          assert (assumed < vars);
-          constraint[assumed++] = -lit;
-
-          for (int other = idx + 1; other <= vars; other++) {
-            int lit_other = candidates[other];
-            if (!lit_other)
-              continue;
-            if (!no_fixed && fix_candidate (other))
-              continue;
-            assert (assumed < vars);
-            constraint[assumed++] = -lit_other;
-
-            if (assumed == constraint_limit)
-              break;
-          }
-
-          if (assumed == 1)
-            goto ASSUME_NEGATION_OF_SINGLE_BACKBONE_CANDIDATE;
-
-          dbg ("assuming negation of %d remaining backbone "
-               "candidates starting with variable %d",
-               assumed, idx);
-
-          if (no_constrain) {
-            activation_variable++;
-            dbg ("new activation variable %s", activation_variable);
-            solver->add (activation_variable);
-            for (int i = 0; i != assumed; i++)
-              solver->add (constraint[i]);
-            solver->add (0);
-            solver->assume (-activation_variable);
-          } else {
-            for (int i = 0; i != assumed; i++)
-              solver->constrain (constraint[i]);
-            solver->constrain (0);
-          }
-
-          last = solve ();
-          if (last == 10) {
-            dbg ("constraining negation of %d backbones candidates "
-                 "starting with variable %d all-at-once produced model",
-                 assumed, idx);
-            int other = drop_first_candidate (idx);
-            filter_candidates (other + 1);
-            try_to_flip_remaining (idx);
-          }
-
-          if (no_constrain) {
-            solver->add (activation_variable);
-            solver->add (0);
-          }
-
-          if (last == 10) {
-
-            lit = candidates[idx];
-            if (lit)
-              goto TRY_SAME_CANDIDATE_AGAIN;
+#ifndef NFLIP
+    if (bulk_flip)
+      init_sweep ();
+#endif
 
-            continue; // ... with next candidate.
-          }
+    reset_milestones ();
 
-          assert (last == 20);
-          msg ("%d remaining candidates starting at %d "
-               "shown to be backbones in one call",
-               assumed, lit);
-          backbone_variables (assumed); // Plural!  So all assumed.
-          continue;
-        }
+    if (verify)
+      res = verify_backbones ();
+    else if (cubes)
+      res = extract_cubes ();
+    else if (server)
+      res = extract_server ();
+    else
+      res = extract ();
 
-      ASSUME_NEGATION_OF_SINGLE_BACKBONE_CANDIDATE:
-
-        dbg ("no other literal besides %d remains a backbone candidate",
-             lit);
-
-        dbg ("assuming negation %d of backbone candidate %d", -lit, lit);
-        solver->assume (-lit);
-        last = solve ();
-        if (last == 10) {
-          dbg ("found model satisfying single assumed "
-               "negation %d of backbone candidate %d",
-               -lit, lit);
-          drop_candidate (idx);
-          filter_candidates (idx + 1);
-          assert (!candidates[idx]);
-          try_to_flip_remaining (idx + 1);
-        } else {
-          assert (last == 20);
-          dbg ("no model with %d thus found backbone literal %d", -lit,
-               lit);
-          backbone_variable (idx); // Singular! So only this one.
-        }
-      }
+    if (cubes || server || verify)
+      printf ("s %sSATISFIABLE\n", res == 10 ? "" : "UN");
+    else if (res == 10) {
 
       // All backbones found! So terminate the backbone list with 'b 0'.
 
-      if (!no_print) {
-        fprintf (files.backbone.file, "b 0\n");
-        fflush (files.backbone.file);
-      }
+      if (!no_print)
+        write_record ('b', 0, 0);
+      flush_output ();
 
       // We only print 's SATISFIABLE' here which is supposed to indicate
       // that the run completed.  Otherwise printing it before printing
@@ -1787,67 +5682,26 @@ int main (int argc, char **argv) {
       line ();
       printf ("s SATISFIABLE\n");
       fflush (stdout);
-
-#ifndef NDEBUG
-
-      if (res == 10) {
-
-        // At the end all variables are either backbones or filtered.
-
-        {
-          size_t count = 0;
-          for (int idx = 1; idx <= vars; idx++)
-            if (fixed[idx])
-              count++;
-
-          assert (count == statistics.backbones);
-        }
-
-        {
-          size_t count = 0;
-          for (int idx = 1; idx <= vars; idx++)
-            if (!fixed[idx])
-              count++;
-
-          assert (count == statistics.dropped);
-        }
-
-        assert (statistics.backbones + statistics.dropped == (size_t) vars);
-      }
-
-#endif
-
-      delete[] candidates;
-      delete[] fixed;
-
-      if (!one_by_one)
-        delete[] constraint;
-
-      if (cores)
-        delete[] core;
-
-      if (checker) {
-        if (statistics.checked < (size_t) vars)
-          fatal ("checked %zu literals and not all %d variables",
-                 statistics.checked, vars);
-        else if (statistics.checked > (size_t) vars)
-          fatal ("checked %zu literals thus more than all %d variables",
-                 statistics.checked, vars);
-        delete checker;
-      }
     } else {
       assert (res == 20);
       printf ("s UNSATISFIABLE\n");
     }
 
+    flush_output ();
+    if (checkpoint)
+      write_checkpoint ();
+    if (trace)
+      write_trace ();
     if (files.backbone.close)
       fclose (files.backbone.file);
+    files.backbone.file = 0;
 
     print_statistics ();
     dbg ("deleting solver");
     CaDiCaL::Signal::reset ();
   }
 
+  delete[] workers;
   delete solver;
 
   line ();
@@ -1855,3 +5709,5 @@ int main (int argc, char **argv) {
 
   return res;
 }
+
+#endif
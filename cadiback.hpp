@@ -0,0 +1,106 @@
+#ifndef _cadiback_hpp_INCLUDED
+#define _cadiback_hpp_INCLUDED
+
+// Library interface to embed 'CadiBack' into other programs, built as
+// 'libcadiback.a' from the same source as the stand-alone tool, i.e.,
+// from 'cadiback.cpp' compiled with '-DNMAIN'.  The typical use is
+//
+//   CaDiCaL::Solver solver;
+//   ... // add clauses
+//   CadiBack::Backbone backbone (&solver);
+//   backbone.set ("big");
+//   backbone.on_backbone ([] (int lit) { ... });
+//   if (backbone.extract () == 10)
+//     for (auto lit : backbone.backbones ())
+//       ...
+//
+// The solver is neither copied nor owned and is used incrementally.  It
+// keeps learned clauses and might get backbones added as units, which does
+// not change its set of models.  Adding clauses and calling 'extract'
+// again is supported too.  With 'no-constrain' however, activation
+// variables beyond the original variables are added.
+
+// All the options and the state of the extraction algorithm are kept in
+// static variables of 'cadiback.cpp'.  Thus 'extract' calls of different
+// 'Backbone' objects are serialized by a global lock.  Calling 'extract'
+// recursively from within a callback is not allowed.
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace CaDiCaL {
+class Solver;
+}
+
+namespace CadiBack {
+
+struct Incremental;
+
+class Backbone {
+
+  CaDiCaL::Solver *solver;
+  Incremental *incremental;
+  std::vector<std::pair<std::string, int>> options;
+  std::function<void (int)> backbone_callback, dropped_callback;
+  std::vector<int> found;
+  std::string error_message;
+
+public:
+  Backbone (CaDiCaL::Solver *);
+  ~Backbone ();
+
+  // Options are the long command line options without leading '--', e.g.,
+  // 'set ("big-lanes")', 'set ("threads", 4)' or 'set ("check")'. Further
+  // 'verbosity' sets the verbosity level (default '-1' which is quiet).
+  // Returns 'false' for unknown options and invalid values.
+  //
+  // The library only option 'incremental' keeps the backbones and the
+  // models witnessing dropped candidates of the last call to 'extract'.
+  // The next call then only checks candidates without a witness model
+  // satisfying the clauses added (through 'add') and the assumptions.
+  //
+  bool set (const char *name, int value = 1);
+
+  // Add a literal of a clause (zero terminated) to the solver.  With
+  // 'incremental' all clauses after the first 'extract' need to be added
+  // through this function, since witness models are only checked against
+  // those.  Otherwise reused backbones and dropped candidates are unsound.
+  //
+  void add (int lit);
+
+  // Determine the backbone of the next 'extract' under this assumption.
+  // As in 'CaDiCaL' assumptions are reset afterwards.
+  //
+  void assume (int lit);
+
+  // Called for each backbone literal and each dropped candidate variable as
+  // soon as it is determined.  With 'threads' these are called from worker
+  // threads but never concurrently.
+  //
+  void on_backbone (std::function<void (int lit)>);
+  void on_dropped (std::function<void (int idx)>);
+
+  // Returns '10' if the formula is satisfiable, '20' if it is
+  // unsatisfiable and '0' if the options do not make sense together
+  // (see 'error').
+  //
+  int extract ();
+
+  // The backbone literals found by the last successful call to 'extract'.
+  //
+  const std::vector<int> &backbones () const { return found; }
+
+  // Message describing why the last 'extract' call returned '0'.
+  //
+  const char *error () const { return error_message.c_str (); }
+
+  // Print statistics of the last call to 'extract' (times accumulate).
+  //
+  void statistics ();
+};
+
+} // namespace CadiBack
+
+#endif
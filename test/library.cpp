@@ -0,0 +1,81 @@
+// Links 'libcadiback.a' through 'cadiback.hpp' and checks the backbones
+// returned by 'CadiBack::Backbone' for 'test/example.cnf', first for a
+// single call and then for incremental queries with added clauses and
+// assumptions.
+
+#include "cadiback.hpp"
+
+#include "cadical.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <initializer_list>
+#include <vector>
+
+static int checks;
+
+static void die (const char *what, const std::vector<int> &lits) {
+  fprintf (stderr, "test/library: error: %s:", what);
+  for (auto lit : lits)
+    fprintf (stderr, " %d", lit);
+  fputc ('\n', stderr);
+  exit (1);
+}
+
+static void add_example (CadiBack::Backbone &backbone) {
+  const int clauses[] = {1, 2, 0, 1, -2, 0, 2, -3, 0, -2, -3, 0};
+  for (auto lit : clauses)
+    backbone.add (lit);
+}
+
+static void check (CadiBack::Backbone &backbone, int expected_res,
+                   std::initializer_list<int> expected) {
+  const int res = backbone.extract ();
+  if (res != expected_res)
+    die ("unexpected result of 'extract'", {res, expected_res});
+  checks++;
+  if (res != 10)
+    return;
+  std::vector<int> backbones = backbone.backbones ();
+  std::sort (backbones.begin (), backbones.end ());
+  std::vector<int> sorted = expected;
+  std::sort (sorted.begin (), sorted.end ());
+  if (backbones != sorted)
+    die ("unexpected backbones", backbones);
+}
+
+int main () {
+  {
+    CaDiCaL::Solver solver;
+    CadiBack::Backbone backbone (&solver);
+    add_example (backbone);
+    if (backbone.set ("no-such-option"))
+      die ("unknown option accepted", {});
+    std::vector<int> reported;
+    backbone.on_backbone ([&] (int lit) { reported.push_back (lit); });
+    check (backbone, 10, {1, -3});
+    std::sort (reported.begin (), reported.end ());
+    if (reported != std::vector<int>{-3, 1})
+      die ("unexpected backbones reported by 'on_backbone'", reported);
+  }
+  {
+    CaDiCaL::Solver solver;
+    CadiBack::Backbone backbone (&solver);
+    if (!backbone.set ("incremental") || !backbone.set ("cores"))
+      die ("valid option rejected", {});
+    add_example (backbone);
+    check (backbone, 10, {1, -3});
+    backbone.add (2), backbone.add (0);
+    check (backbone, 10, {1, 2, -3});
+    backbone.add (4), backbone.add (5), backbone.add (0);
+    backbone.assume (-4);
+    check (backbone, 10, {1, 2, -3, -4, 5});
+    check (backbone, 10, {1, 2, -3});
+    backbone.assume (3);
+    check (backbone, 20, {});
+    check (backbone, 10, {1, 2, -3});
+  }
+  printf ("test/library: passed %d checks\n", checks);
+  return 0;
+}
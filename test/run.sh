@@ -8,6 +8,7 @@ die () {
 cd `dirname $0` || exit 1
 
 [ -f ../cadiback ] || die "could not find '../cadiback'"
+[ -f library ] || die "could not find 'library' (try 'make test')"
 
 runs=0
 
@@ -20,15 +21,17 @@ run () {
   err=$name.err
   pretty="./cadiback"
   cmd="../cadiback"
+  input=/dev/null
   while [ $# -gt 0 ]
   do
     case $1 in
-      -*) cmd="$cmd $1"; pretty="$pretty $1";;
-      *) cmd="$cmd $1"; pretty="$pretty test/$1";;
+      *.cnf|*.cubes|*.project) cmd="$cmd $1"; pretty="$pretty test/$1";;
+      *.requests) input=$1; pretty="$pretty < test/$1";;
+      *) cmd="$cmd $1"; pretty="$pretty $1";;
     esac
     shift
   done
-  $cmd 1>$log 2>$err
+  $cmd 1>$log 2>$err <$input
   status=$?
   if [ $status = $expected ]
   then
@@ -56,4 +59,41 @@ run 20 false1 false1.cnf
 
 run 10 battleship battleship.cnf
 
+run 10 models battleship.cnf --models 3 --models-limit 100
+run 10 threads1 battleship.cnf --threads 2
+run 10 slice1 battleship.cnf --slice 1/2 --print-dropped
+run 10 slice2 battleship.cnf --slice 2/2 --print-dropped
+run 10 lanes battleship.cnf --big-lanes --threads 2
+run 10 reduce battleship.cnf --big-reduce
+run 10 equivalences equivalences.cnf --big --one-by-one --no-filter
+run 10 els equivalences.cnf --els --one-by-one --no-filter
+run 10 probe example.cnf --probe -s
+run 10 nommap battleship.cnf --no-mmap
+run 10 cubes battleship.cnf --cubes battleship.cubes
+run 10 server battleship.cnf --server battleship.requests
+run 10 project battleship.cnf --project battleship.project --check
+run 10 cache battleship.cnf --cache 4 --no-filter
+run 10 adaptive battleship.cnf --adaptive --cores
+run 10 limits battleship.cnf --adaptive --adaptive-limit 4 --cores --core-limit 2
+run 10 order battleship.cnf --order binary --cores
+run 10 bulkflip battleship.cnf --bulk-flip --really-flip
+run 10 binary example.cnf --binary --flush calls
+run 10 flush battleship.cnf --flush time --flush-interval 2
+run 10 checkpoint battleship.cnf --checkpoint resume.ckp --checkpoint-interval 1
+run 10 resume battleship.cnf --resume resume.ckp --check
+run 10 budget battleship.cnf --budget 1
+run 10 checkers battleship.cnf --check --checkers 2 --threads 2
+run 10 verify battleship.cnf --verify resume.ckp --checkers 2
+run 10 trace battleship.cnf --trace battleship.trace --trace-format chrome --cores
+run 10 progress example.cnf --progress 1 -s
+
+if ./library 1>library.log 2>library.err
+then
+  echo "./test/library # 'library' succeeded linking 'libcadiback.a'"
+else
+  echo "./test/library # 'library' failed (see 'test/library.err')"
+  exit 1
+fi
+runs=`expr $runs + 1`
+
 echo "passed $runs test runs"